@@ -0,0 +1,378 @@
+////////////////////////////////////////////////////////////////////////////////
+// bench.cc
+// author: jcramb@gmail.com
+//
+// standalone vterm benchmark, replays byte streams through the emulator
+// against a headless curses screen and times parsing and painting apart
+//
+// usage: ./bench [-n | -a] [-s lines] [-m MB] [-c chunk] [file ...]
+//
+// with no files a set of synthetic workloads is run, otherwise each file
+// is replayed as a recorded stream (e.g. captured with `script -q`, or a
+// message trace from `./server -t`, which replays the shell output). with
+// -n the null backend is used, so only the emulator itself is measured,
+// -a uses the ansi backend instead of curses, and -s keeps the given 
+// number of lines of scrollback
+
+#include <sys/stat.h>
+#include <curses.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+
+#include <cstdint>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "core.h"
+#include "vterm.h"
+#include "trace.h"
+
+#define BENCH_ROWS 50
+#define BENCH_COLS 160
+#define BENCH_CHUNK 4096        // bytes per read, one paint per read
+#define BENCH_MB 32             // bytes replayed per workload
+
+////////////////////////////////////////////////////////////////////////////////
+// timing helpers
+
+static uint64_t bench_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// deterministic generator so runs are comparable
+
+static unsigned g_seed = 1;
+static bool g_null = false;
+static bool g_ansi = false;
+static unsigned g_scrollback = 0;
+static size_t g_out_bytes = 0;          // bytes curses wrote to the terminal
+
+static unsigned bench_rand(unsigned n) {
+    g_seed = g_seed * 1103515245 + 12345;
+    return (g_seed >> 16) % n;
+}
+
+static void append_word(std::string & s) {
+    int len = 1 + bench_rand(10);
+    for (int i = 0; i < len; i++) {
+        s += (char)('a' + bench_rand(26));
+    }
+}
+
+static void appendf(std::string & s, const char * fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static void appendf(std::string & s, const char * fmt, ...) {
+    char buf[64];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    s += buf;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// synthetic workloads
+
+// plain text, like cat of a source file
+static std::string gen_text() {
+    std::string s;
+    while (s.size() < 1 << 20) {
+        int cols = bench_rand(BENCH_COLS - 10);
+        while (cols > 0) {
+            append_word(s);
+            s += ' ';
+            cols -= 6;
+        }
+        s += "\r\n";
+    }
+    return s;
+}
+
+// heavy colour, like ls --color or a syntax highlighted diff
+static std::string gen_sgr() {
+    std::string s;
+    while (s.size() < 1 << 20) {
+        for (int i = 0; i < 8; i++) {
+            switch (bench_rand(4)) {
+                case 0: appendf(s, "\e[%dm", 30 + bench_rand(8)); break;
+                case 1: appendf(s, "\e[1;%d;%dm", 90 + bench_rand(8),
+                                40 + bench_rand(8)); break;
+                case 2: appendf(s, "\e[38;5;%dm", bench_rand(256)); break;
+                case 3: appendf(s, "\e[48;2;%d;%d;%dm", bench_rand(256),
+                                bench_rand(256), bench_rand(256)); break;
+            }
+            append_word(s);
+            s += "\e[0m ";
+        }
+        s += "\r\n";
+    }
+    return s;
+}
+
+// full screen redraws, like vim scrolling a buffer or top refreshing
+static std::string gen_tui() {
+    std::string s;
+    while (s.size() < 1 << 20) {
+        s += "\e[?25l\e[H";
+        for (int row = 1; row < BENCH_ROWS; row++) {
+            appendf(s, "\e[%d;1H\e[33m%4d \e[0m", row, bench_rand(9999));
+            int cols = bench_rand(BENCH_COLS - 20);
+            while (cols > 0) {
+                if (bench_rand(4) == 0) {
+                    appendf(s, "\e[%dm", 31 + bench_rand(7));
+                    append_word(s);
+                    s += "\e[m";
+                } else {
+                    append_word(s);
+                }
+                s += ' ';
+                cols -= 6;
+            }
+            s += "\e[K";
+        }
+        appendf(s, "\e[%d;1H\e[7m", BENCH_ROWS);
+        appendf(s, " bench.cc [+] %d,%d ", bench_rand(999), bench_rand(99));
+        s += "\e[K\e[27m";
+        appendf(s, "\e[%d;%dH\e[?25h", 1 + bench_rand(BENCH_ROWS - 1),
+                1 + bench_rand(BENCH_COLS));
+    }
+    return s;
+}
+
+// single characters at random positions, like a status dashboard
+static std::string gen_cursor() {
+    std::string s;
+    while (s.size() < 1 << 20) {
+        appendf(s, "\e[%d;%dH%c", 1 + bench_rand(BENCH_ROWS),
+                1 + bench_rand(BENCH_COLS), 'A' + bench_rand(26));
+    }
+    return s;
+}
+
+// long scrolling output, full screen and inside a scrolling region
+static std::string gen_scroll() {
+    std::string s;
+    while (s.size() < 1 << 20) {
+        if (bench_rand(64) == 0) {
+            appendf(s, "\e[%d;%dr\e[%dH", 2, BENCH_ROWS - 1, BENCH_ROWS - 1);
+        } else if (bench_rand(64) == 0) {
+            appendf(s, "\e[r\e[%dH", BENCH_ROWS);
+        }
+        append_word(s);
+        s += "\n";
+    }
+    return s;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// read a recorded stream from disk, message traces are reduced to the shell
+// output the server rendered
+
+static bool load_trace(const char * path, std::string & out) {
+    trace_reader trace;
+    if (trace.open(path) < 0) {
+        return false;
+    }
+    const trace_record * rec;
+    const char * body;
+    out.clear();
+    while (trace.next(&rec, &body)) {
+        if (rec->dir == TRACE_RX && rec->type == MSG_RVSHELL) {
+            out.append(body, rec->len);
+        }
+    }
+    return true;
+}
+
+static bool load_file(const char * path, std::string & out) {
+    if (load_trace(path, out)) {
+        return true;
+    }
+    FILE * f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return false;
+    }
+    char buf[65536];
+    size_t n;
+    out.clear();
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        out.append(buf, n);
+    }
+    fclose(f);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// curses writes to a scratch file, emptied after every frame once the bytes 
+// a real terminal would have been sent are counted
+
+static void count_output(FILE * out) {
+    int fd = fileno(out);
+    off_t len = lseek(fd, 0, SEEK_CUR);
+    if (len > 0) {
+        g_out_bytes += len;
+        lseek(fd, 0, SEEK_SET);
+        if (ftruncate(fd, 0) < 0) return;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// replay a stream in chunks, timing parse and paint separately
+
+static void run(const char * name, const std::string & data,
+                size_t total, size_t chunk, FILE * out) {
+
+    if (data.empty()) {
+        printf("%-10s empty\n", name);
+        return;
+    }
+
+    WINDOW * wnd = NULL;
+    vterm_ansi_t * ansi = NULL;
+    int null_fd = -1;
+    vterm_t * vterm = vterm_create(BENCH_COLS, BENCH_ROWS, 0);
+    vterm_set_scrollback(vterm, g_scrollback, 0);
+    if (g_ansi) {
+        null_fd = open("/dev/null", O_WRONLY);
+        ansi = vterm_ansi_create(null_fd, BENCH_ROWS, BENCH_COLS);
+        vterm_set_backend(vterm, &vterm_ansi_backend, ansi);
+    } else if (!g_null) {
+        wnd = newwin(BENCH_ROWS, BENCH_COLS, 0, 0);
+        vterm_wnd_set(vterm, wnd);
+    }
+    g_out_bytes = 0;
+
+    uint64_t parse_ns = 0;
+    uint64_t paint_ns = 0;
+    size_t bytes = 0;
+    size_t frames = 0;
+    size_t pos = 0;
+
+    while (bytes < total) {
+        size_t len = MIN(chunk, data.size() - pos);
+
+        uint64_t t0 = bench_now_ns();
+        vterm_render(vterm, data.data() + pos, len);
+        uint64_t t1 = bench_now_ns();
+        vterm_update(vterm);
+        if (wnd != NULL) {
+            wnoutrefresh(wnd);
+            doupdate();
+        }
+        uint64_t t2 = bench_now_ns();
+        if (wnd != NULL) {
+            count_output(out);
+        }
+
+        parse_ns += t1 - t0;
+        paint_ns += t2 - t1;
+        bytes += len;
+        frames++;
+
+        pos += len;
+        if (pos >= data.size()) pos = 0;
+    }
+
+    if (ansi != NULL) {
+        g_out_bytes = vterm_ansi_get_bytes(ansi);
+    }
+
+    double mb = bytes / (1024.0 * 1024.0);
+    printf("%-10s %8.1f MB  parse %8.1f MB/s %7.2f ns/B"
+           "  paint %8.1f MB/s %7.2f ns/B %8.1f us/frame %8.1f MB out\n",
+           name, mb,
+           mb / (parse_ns / 1e9), (double)parse_ns / bytes,
+           mb / (paint_ns / 1e9), (double)paint_ns / bytes,
+           paint_ns / 1e3 / frames, g_out_bytes / (1024.0 * 1024.0));
+
+    vterm_destroy(vterm);
+    if (wnd != NULL) delwin(wnd);
+    if (ansi != NULL) {
+        vterm_ansi_destroy(ansi);
+        close(null_fd);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// run benchmark workloads against a curses screen on /dev/null
+
+int main(int argc, char ** argv) {
+    size_t total = (size_t)BENCH_MB << 20;
+    size_t chunk = BENCH_CHUNK;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "nas:m:c:h")) != -1) {
+        switch (opt) {
+            case 'n': g_null = true; break;
+            case 'a': g_ansi = true; break;
+            case 's': g_scrollback = atoi(optarg); break;
+            case 'm': total = (size_t)atoi(optarg) << 20; break;
+            case 'c': chunk = MAX(1, atoi(optarg)); break;
+            default:
+                fprintf(stderr, "usage: %s [-n | -a] [-s lines] [-m MB] "
+                        "[-c chunk] [file ...]\n",
+                        argv[0]);
+                return 1;
+        }
+    }
+
+    // headless screen, output is counted and discarded but still fully 
+    // generated
+    FILE * out = NULL;
+    FILE * in = NULL;
+    SCREEN * screen = NULL;
+    if (!g_null && !g_ansi) {
+        out = tmpfile();
+        in = fopen("/dev/null", "r");
+        const char * term = getenv("TERM");
+        screen = newterm((char*)"xterm-256color", out, in);
+        if (screen == NULL && term != NULL) {
+            screen = newterm((char*)term, out, in);
+        }
+        if (screen == NULL) {
+            fprintf(stderr, "fatal: unable to create curses screen\n");
+            return 1;
+        }
+        set_term(screen);
+        start_color();
+        use_default_colors();
+        resizeterm(BENCH_ROWS, BENCH_COLS);
+    }
+
+    printf("vterm bench: %dx%d, %zu byte chunks, %zu MB per workload, "
+           "%s backend\n", BENCH_COLS, BENCH_ROWS, chunk, total >> 20,
+           g_null ? "null" : (g_ansi ? "ansi" : "curses"));
+
+    if (optind < argc) {
+        std::string data;
+        for (int i = optind; i < argc; i++) {
+            if (load_file(argv[i], data)) {
+                run(argv[i], data, total, chunk, out);
+            }
+        }
+    } else {
+        run("text", gen_text(), total, chunk, out);
+        run("sgr", gen_sgr(), total, chunk, out);
+        run("tui", gen_tui(), total, chunk, out);
+        run("cursor", gen_cursor(), total, chunk, out);
+        run("scroll", gen_scroll(), total, chunk, out);
+    }
+
+    if (screen != NULL) {
+        endwin();
+        delscreen(screen);
+        fclose(out);
+        fclose(in);
+    }
+    return 0;
+}
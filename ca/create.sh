@@ -22,8 +22,8 @@ openssl req -x509 -newkey rsa:2048 -out $DIR/cacert.pem -outform PEN -days 1825
 openssl x509 -in $DIR/cacert.pem -out $DIR/cacert.crt
 
 export OPENSSL_CONF=$DIR/server.cnf
-openssl req -newkey rsa:1024 -keyout $DIR/tempkey.pem -keyform PEM -out $DIR/tempreq.pem -outform PEM
-openssl rsa < $DIR/tempkey.pem > $DIR/shell_key.pem
+openssl req -newkey ec -pkeyopt ec_paramgen_curve:prime256v1 -keyout $DIR/tempkey.pem -keyform PEM -out $DIR/tempreq.pem -outform PEM
+openssl pkey < $DIR/tempkey.pem > $DIR/shell_key.pem
 
 export OPENSSL_CONF=$DIR/caconfig.cnf
 openssl ca -in $DIR/tempreq.pem -out $DIR/shell_crt.pem
@@ -31,5 +31,5 @@ openssl ca -in $DIR/tempreq.pem -out $DIR/shell_crt.pem
 #rm -f $DIR/tempreq.pem
 cat $DIR/shell_key.pem $DIR/shell_crt.pem > $DIR/shell.pem
 
-openssl req -x509 -nodes -days 365 -newkey rsa:1024 -keyout $DIR/client.pem -out $DIR/client.pem
+openssl req -x509 -nodes -days 365 -newkey ec -pkeyopt ec_paramgen_curve:prime256v1 -keyout $DIR/client.pem -out $DIR/client.pem
 openssl pkcs12 -export -out $DIR/client.pfx -in $DIR/client.pem -name "client cert"
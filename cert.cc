@@ -0,0 +1,383 @@
+#include "cert.h"
+
+char _crtbuf[] = {
+  0x43, 0x65, 0x72, 0x74, 0x69, 0x66, 0x69, 0x63, 0x61, 0x74, 0x65, 0x3a, 
+  0x0a, 0x20, 0x20, 0x20, 0x20, 0x44, 0x61, 0x74, 0x61, 0x3a, 0x0a, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x56, 0x65, 0x72, 0x73, 0x69, 
+  0x6f, 0x6e, 0x3a, 0x20, 0x33, 0x20, 0x28, 0x30, 0x78, 0x32, 0x29, 0x0a, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x53, 0x65, 0x72, 0x69, 
+  0x61, 0x6c, 0x20, 0x4e, 0x75, 0x6d, 0x62, 0x65, 0x72, 0x3a, 0x20, 0x31, 
+  0x20, 0x28, 0x30, 0x78, 0x31, 0x29, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x53, 
+  0x69, 0x67, 0x6e, 0x61, 0x74, 0x75, 0x72, 0x65, 0x20, 0x41, 0x6c, 0x67, 
+  0x6f, 0x72, 0x69, 0x74, 0x68, 0x6d, 0x3a, 0x20, 0x73, 0x68, 0x61, 0x31, 
+  0x57, 0x69, 0x74, 0x68, 0x52, 0x53, 0x41, 0x45, 0x6e, 0x63, 0x72, 0x79, 
+  0x70, 0x74, 0x69, 0x6f, 0x6e, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x49, 0x73, 0x73, 0x75, 0x65, 0x72, 0x3a, 0x20, 0x43, 0x4e, 
+  0x3d, 0x4c, 0x65, 0x67, 0x69, 0x74, 0x43, 0x41, 0x2c, 0x20, 0x53, 0x54, 
+  0x3d, 0x44, 0x43, 0x2c, 0x20, 0x43, 0x3d, 0x55, 0x53, 0x2f, 0x65, 0x6d, 
+  0x61, 0x69, 0x6c, 0x41, 0x64, 0x64, 0x72, 0x65, 0x73, 0x73, 0x3d, 0x72, 
+  0x6f, 0x6f, 0x74, 0x40, 0x64, 0x65, 0x66, 0x65, 0x6e, 0x73, 0x65, 0x2e, 
+  0x67, 0x6f, 0x76, 0x2c, 0x20, 0x4f, 0x3d, 0x41, 0x63, 0x6d, 0x65, 0x2c, 
+  0x20, 0x4f, 0x55, 0x3d, 0x42, 0x69, 0x7a, 0x58, 0x0a, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x56, 0x61, 0x6c, 0x69, 0x64, 0x69, 0x74, 
+  0x79, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x4e, 0x6f, 0x74, 0x20, 0x42, 0x65, 0x66, 0x6f, 0x72, 0x65, 
+  0x3a, 0x20, 0x4d, 0x61, 0x72, 0x20, 0x32, 0x38, 0x20, 0x30, 0x35, 0x3a, 
+  0x34, 0x37, 0x3a, 0x33, 0x37, 0x20, 0x32, 0x30, 0x31, 0x36, 0x20, 0x47, 
+  0x4d, 0x54, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x4e, 0x6f, 0x74, 0x20, 0x41, 0x66, 0x74, 0x65, 0x72, 
+  0x20, 0x3a, 0x20, 0x4d, 0x61, 0x72, 0x20, 0x32, 0x37, 0x20, 0x30, 0x35, 
+  0x3a, 0x34, 0x37, 0x3a, 0x33, 0x37, 0x20, 0x32, 0x30, 0x32, 0x31, 0x20, 
+  0x47, 0x4d, 0x54, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x53, 0x75, 0x62, 0x6a, 0x65, 0x63, 0x74, 0x3a, 0x20, 0x43, 0x4e, 0x3d, 
+  0x4c, 0x65, 0x67, 0x69, 0x74, 0x53, 0x76, 0x72, 0x2c, 0x20, 0x53, 0x54, 
+  0x3d, 0x44, 0x43, 0x2c, 0x20, 0x43, 0x3d, 0x55, 0x53, 0x2f, 0x65, 0x6d, 
+  0x61, 0x69, 0x6c, 0x41, 0x64, 0x64, 0x72, 0x65, 0x73, 0x73, 0x3d, 0x72, 
+  0x6f, 0x6f, 0x74, 0x40, 0x64, 0x65, 0x66, 0x65, 0x6e, 0x73, 0x65, 0x2e, 
+  0x67, 0x6f, 0x76, 0x2c, 0x20, 0x4f, 0x3d, 0x41, 0x63, 0x6d, 0x65, 0x2c, 
+  0x20, 0x4f, 0x55, 0x3d, 0x42, 0x69, 0x7a, 0x58, 0x0a, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x53, 0x75, 0x62, 0x6a, 0x65, 0x63, 0x74, 
+  0x20, 0x50, 0x75, 0x62, 0x6c, 0x69, 0x63, 0x20, 0x4b, 0x65, 0x79, 0x20, 
+  0x49, 0x6e, 0x66, 0x6f, 0x3a, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x50, 0x75, 0x62, 0x6c, 0x69, 0x63, 
+  0x20, 0x4b, 0x65, 0x79, 0x20, 0x41, 0x6c, 0x67, 0x6f, 0x72, 0x69, 0x74, 
+  0x68, 0x6d, 0x3a, 0x20, 0x72, 0x73, 0x61, 0x45, 0x6e, 0x63, 0x72, 0x79, 
+  0x70, 0x74, 0x69, 0x6f, 0x6e, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x50, 0x75, 
+  0x62, 0x6c, 0x69, 0x63, 0x2d, 0x4b, 0x65, 0x79, 0x3a, 0x20, 0x28, 0x31, 
+  0x30, 0x32, 0x34, 0x20, 0x62, 0x69, 0x74, 0x29, 0x0a, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x4d, 0x6f, 0x64, 0x75, 0x6c, 0x75, 0x73, 0x3a, 0x0a, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x30, 0x30, 0x3a, 0x61, 0x64, 0x3a, 
+  0x34, 0x33, 0x3a, 0x39, 0x35, 0x3a, 0x30, 0x31, 0x3a, 0x38, 0x62, 0x3a, 
+  0x34, 0x61, 0x3a, 0x35, 0x38, 0x3a, 0x64, 0x39, 0x3a, 0x61, 0x38, 0x3a, 
+  0x35, 0x63, 0x3a, 0x66, 0x32, 0x3a, 0x66, 0x65, 0x3a, 0x34, 0x30, 0x3a, 
+  0x63, 0x33, 0x3a, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x30, 0x37, 0x3a, 0x31, 0x36, 0x3a, 0x61, 0x33, 0x3a, 0x65, 0x65, 0x3a, 
+  0x30, 0x65, 0x3a, 0x65, 0x31, 0x3a, 0x33, 0x35, 0x3a, 0x35, 0x64, 0x3a, 
+  0x39, 0x35, 0x3a, 0x30, 0x32, 0x3a, 0x35, 0x31, 0x3a, 0x34, 0x61, 0x3a, 
+  0x66, 0x31, 0x3a, 0x33, 0x64, 0x3a, 0x30, 0x32, 0x3a, 0x0a, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x61, 0x39, 0x3a, 0x66, 0x64, 0x3a, 
+  0x38, 0x34, 0x3a, 0x39, 0x64, 0x3a, 0x65, 0x66, 0x3a, 0x34, 0x38, 0x3a, 
+  0x33, 0x31, 0x3a, 0x33, 0x63, 0x3a, 0x66, 0x63, 0x3a, 0x32, 0x37, 0x3a, 
+  0x65, 0x66, 0x3a, 0x65, 0x38, 0x3a, 0x61, 0x61, 0x3a, 0x61, 0x66, 0x3a, 
+  0x38, 0x33, 0x3a, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x39, 0x38, 0x3a, 0x63, 0x35, 0x3a, 0x30, 0x37, 0x3a, 0x30, 0x32, 0x3a, 
+  0x61, 0x63, 0x3a, 0x35, 0x64, 0x3a, 0x30, 0x35, 0x3a, 0x35, 0x39, 0x3a, 
+  0x66, 0x30, 0x3a, 0x31, 0x30, 0x3a, 0x64, 0x33, 0x3a, 0x66, 0x39, 0x3a, 
+  0x35, 0x36, 0x3a, 0x32, 0x36, 0x3a, 0x39, 0x65, 0x3a, 0x0a, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x62, 0x38, 0x3a, 0x36, 0x30, 0x3a, 
+  0x66, 0x35, 0x3a, 0x33, 0x35, 0x3a, 0x35, 0x37, 0x3a, 0x33, 0x39, 0x3a, 
+  0x33, 0x39, 0x3a, 0x39, 0x39, 0x3a, 0x64, 0x64, 0x3a, 0x35, 0x66, 0x3a, 
+  0x61, 0x34, 0x3a, 0x61, 0x32, 0x3a, 0x36, 0x32, 0x3a, 0x30, 0x63, 0x3a, 
+  0x37, 0x62, 0x3a, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x34, 0x39, 0x3a, 0x35, 0x62, 0x3a, 0x31, 0x63, 0x3a, 0x34, 0x66, 0x3a, 
+  0x39, 0x35, 0x3a, 0x37, 0x39, 0x3a, 0x65, 0x62, 0x3a, 0x35, 0x34, 0x3a, 
+  0x36, 0x66, 0x3a, 0x37, 0x36, 0x3a, 0x36, 0x34, 0x3a, 0x63, 0x32, 0x3a, 
+  0x35, 0x63, 0x3a, 0x32, 0x33, 0x3a, 0x65, 0x31, 0x3a, 0x0a, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x35, 0x63, 0x3a, 0x65, 0x66, 0x3a, 
+  0x38, 0x35, 0x3a, 0x36, 0x35, 0x3a, 0x38, 0x61, 0x3a, 0x62, 0x33, 0x3a, 
+  0x65, 0x32, 0x3a, 0x35, 0x62, 0x3a, 0x64, 0x32, 0x3a, 0x39, 0x36, 0x3a, 
+  0x30, 0x31, 0x3a, 0x64, 0x30, 0x3a, 0x62, 0x65, 0x3a, 0x63, 0x64, 0x3a, 
+  0x65, 0x35, 0x3a, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x30, 0x66, 0x3a, 0x65, 0x34, 0x3a, 0x37, 0x61, 0x3a, 0x31, 0x31, 0x3a, 
+  0x38, 0x36, 0x3a, 0x35, 0x35, 0x3a, 0x39, 0x65, 0x3a, 0x37, 0x39, 0x3a, 
+  0x35, 0x31, 0x3a, 0x33, 0x38, 0x3a, 0x38, 0x38, 0x3a, 0x63, 0x36, 0x3a, 
+  0x33, 0x32, 0x3a, 0x61, 0x35, 0x3a, 0x66, 0x61, 0x3a, 0x0a, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x30, 0x35, 0x3a, 0x38, 0x31, 0x3a, 
+  0x66, 0x63, 0x3a, 0x38, 0x64, 0x3a, 0x36, 0x61, 0x3a, 0x61, 0x39, 0x3a, 
+  0x64, 0x32, 0x3a, 0x62, 0x34, 0x3a, 0x39, 0x64, 0x0a, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x45, 0x78, 0x70, 0x6f, 0x6e, 0x65, 0x6e, 0x74, 0x3a, 0x20, 0x36, 
+  0x35, 0x35, 0x33, 0x37, 0x20, 0x28, 0x30, 0x78, 0x31, 0x30, 0x30, 0x30, 
+  0x31, 0x29, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x58, 
+  0x35, 0x30, 0x39, 0x76, 0x33, 0x20, 0x65, 0x78, 0x74, 0x65, 0x6e, 0x73, 
+  0x69, 0x6f, 0x6e, 0x73, 0x3a, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x58, 0x35, 0x30, 0x39, 0x76, 0x33, 
+  0x20, 0x42, 0x61, 0x73, 0x69, 0x63, 0x20, 0x43, 0x6f, 0x6e, 0x73, 0x74, 
+  0x72, 0x61, 0x69, 0x6e, 0x74, 0x73, 0x3a, 0x20, 0x0a, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x43, 0x41, 0x3a, 0x46, 0x41, 0x4c, 0x53, 0x45, 0x0a, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x58, 0x35, 
+  0x30, 0x39, 0x76, 0x33, 0x20, 0x4b, 0x65, 0x79, 0x20, 0x55, 0x73, 0x61, 
+  0x67, 0x65, 0x3a, 0x20, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x44, 0x69, 0x67, 
+  0x69, 0x74, 0x61, 0x6c, 0x20, 0x53, 0x69, 0x67, 0x6e, 0x61, 0x74, 0x75, 
+  0x72, 0x65, 0x2c, 0x20, 0x4e, 0x6f, 0x6e, 0x20, 0x52, 0x65, 0x70, 0x75, 
+  0x64, 0x69, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x2c, 0x20, 0x4b, 0x65, 0x79, 
+  0x20, 0x45, 0x6e, 0x63, 0x69, 0x70, 0x68, 0x65, 0x72, 0x6d, 0x65, 0x6e, 
+  0x74, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x58, 0x35, 0x30, 0x39, 0x76, 0x33, 0x20, 0x53, 0x75, 0x62, 
+  0x6a, 0x65, 0x63, 0x74, 0x20, 0x41, 0x6c, 0x74, 0x65, 0x72, 0x6e, 0x61, 
+  0x74, 0x69, 0x76, 0x65, 0x20, 0x4e, 0x61, 0x6d, 0x65, 0x3a, 0x20, 0x0a, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x44, 0x4e, 0x53, 0x3a, 0x64, 0x65, 0x66, 0x65, 
+  0x6e, 0x73, 0x65, 0x2e, 0x67, 0x6f, 0x76, 0x2c, 0x20, 0x44, 0x4e, 0x53, 
+  0x3a, 0x61, 0x6c, 0x74, 0x2e, 0x64, 0x65, 0x66, 0x65, 0x6e, 0x73, 0x65, 
+  0x2e, 0x67, 0x6f, 0x76, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x53, 0x69, 0x67, 
+  0x6e, 0x61, 0x74, 0x75, 0x72, 0x65, 0x20, 0x41, 0x6c, 0x67, 0x6f, 0x72, 
+  0x69, 0x74, 0x68, 0x6d, 0x3a, 0x20, 0x73, 0x68, 0x61, 0x31, 0x57, 0x69, 
+  0x74, 0x68, 0x52, 0x53, 0x41, 0x45, 0x6e, 0x63, 0x72, 0x79, 0x70, 0x74, 
+  0x69, 0x6f, 0x6e, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x37, 0x35, 0x3a, 0x30, 0x65, 0x3a, 0x62, 0x63, 0x3a, 0x38, 0x35, 
+  0x3a, 0x65, 0x30, 0x3a, 0x34, 0x30, 0x3a, 0x37, 0x61, 0x3a, 0x33, 0x30, 
+  0x3a, 0x35, 0x63, 0x3a, 0x62, 0x63, 0x3a, 0x65, 0x66, 0x3a, 0x63, 0x36, 
+  0x3a, 0x35, 0x30, 0x3a, 0x35, 0x35, 0x3a, 0x37, 0x64, 0x3a, 0x34, 0x35, 
+  0x3a, 0x33, 0x62, 0x3a, 0x33, 0x32, 0x3a, 0x0a, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 0x61, 0x3a, 0x38, 0x62, 0x3a, 0x34, 
+  0x38, 0x3a, 0x30, 0x61, 0x3a, 0x65, 0x30, 0x3a, 0x66, 0x31, 0x3a, 0x36, 
+  0x39, 0x3a, 0x35, 0x61, 0x3a, 0x32, 0x32, 0x3a, 0x38, 0x66, 0x3a, 0x30, 
+  0x65, 0x3a, 0x39, 0x35, 0x3a, 0x32, 0x37, 0x3a, 0x32, 0x62, 0x3a, 0x33, 
+  0x64, 0x3a, 0x64, 0x37, 0x3a, 0x38, 0x65, 0x3a, 0x39, 0x32, 0x3a, 0x0a, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x62, 0x63, 0x3a, 
+  0x31, 0x30, 0x3a, 0x36, 0x64, 0x3a, 0x66, 0x30, 0x3a, 0x38, 0x62, 0x3a, 
+  0x32, 0x31, 0x3a, 0x30, 0x34, 0x3a, 0x35, 0x33, 0x3a, 0x62, 0x30, 0x3a, 
+  0x61, 0x64, 0x3a, 0x65, 0x61, 0x3a, 0x61, 0x38, 0x3a, 0x66, 0x30, 0x3a, 
+  0x34, 0x62, 0x3a, 0x65, 0x36, 0x3a, 0x36, 0x66, 0x3a, 0x36, 0x30, 0x3a, 
+  0x33, 0x35, 0x3a, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x35, 0x64, 0x3a, 0x39, 0x66, 0x3a, 0x35, 0x61, 0x3a, 0x35, 0x64, 
+  0x3a, 0x30, 0x38, 0x3a, 0x32, 0x62, 0x3a, 0x62, 0x30, 0x3a, 0x64, 0x39, 
+  0x3a, 0x38, 0x31, 0x3a, 0x66, 0x35, 0x3a, 0x30, 0x39, 0x3a, 0x31, 0x38, 
+  0x3a, 0x31, 0x61, 0x3a, 0x39, 0x33, 0x3a, 0x31, 0x62, 0x3a, 0x39, 0x31, 
+  0x3a, 0x35, 0x38, 0x3a, 0x31, 0x65, 0x3a, 0x0a, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x39, 0x39, 0x3a, 0x38, 0x33, 0x3a, 0x66, 
+  0x32, 0x3a, 0x66, 0x36, 0x3a, 0x64, 0x33, 0x3a, 0x36, 0x30, 0x3a, 0x63, 
+  0x37, 0x3a, 0x63, 0x66, 0x3a, 0x30, 0x31, 0x3a, 0x65, 0x61, 0x3a, 0x31, 
+  0x64, 0x3a, 0x33, 0x63, 0x3a, 0x63, 0x35, 0x3a, 0x34, 0x61, 0x3a, 0x34, 
+  0x33, 0x3a, 0x34, 0x62, 0x3a, 0x34, 0x61, 0x3a, 0x32, 0x66, 0x3a, 0x0a, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x61, 0x33, 0x3a, 
+  0x35, 0x65, 0x3a, 0x38, 0x66, 0x3a, 0x62, 0x64, 0x3a, 0x31, 0x65, 0x3a, 
+  0x39, 0x36, 0x3a, 0x30, 0x32, 0x3a, 0x36, 0x39, 0x3a, 0x36, 0x62, 0x3a, 
+  0x34, 0x32, 0x3a, 0x64, 0x62, 0x3a, 0x63, 0x37, 0x3a, 0x37, 0x66, 0x3a, 
+  0x31, 0x62, 0x3a, 0x35, 0x38, 0x3a, 0x33, 0x64, 0x3a, 0x30, 0x66, 0x3a, 
+  0x63, 0x36, 0x3a, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x66, 0x39, 0x3a, 0x39, 0x63, 0x3a, 0x66, 0x32, 0x3a, 0x38, 0x63, 
+  0x3a, 0x63, 0x30, 0x3a, 0x31, 0x33, 0x3a, 0x64, 0x30, 0x3a, 0x62, 0x32, 
+  0x3a, 0x34, 0x61, 0x3a, 0x65, 0x66, 0x3a, 0x35, 0x31, 0x3a, 0x61, 0x63, 
+  0x3a, 0x65, 0x34, 0x3a, 0x30, 0x30, 0x3a, 0x36, 0x38, 0x3a, 0x61, 0x64, 
+  0x3a, 0x66, 0x65, 0x3a, 0x66, 0x36, 0x3a, 0x0a, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x30, 0x66, 0x3a, 0x62, 0x30, 0x3a, 0x39, 
+  0x35, 0x3a, 0x37, 0x38, 0x3a, 0x35, 0x33, 0x3a, 0x64, 0x35, 0x3a, 0x66, 
+  0x35, 0x3a, 0x62, 0x62, 0x3a, 0x31, 0x30, 0x3a, 0x61, 0x36, 0x3a, 0x62, 
+  0x65, 0x3a, 0x39, 0x32, 0x3a, 0x63, 0x65, 0x3a, 0x62, 0x66, 0x3a, 0x61, 
+  0x38, 0x3a, 0x62, 0x30, 0x3a, 0x66, 0x34, 0x3a, 0x62, 0x36, 0x3a, 0x0a, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x30, 0x35, 0x3a, 
+  0x63, 0x34, 0x3a, 0x38, 0x30, 0x3a, 0x30, 0x30, 0x3a, 0x39, 0x30, 0x3a, 
+  0x35, 0x66, 0x3a, 0x39, 0x38, 0x3a, 0x35, 0x33, 0x3a, 0x34, 0x34, 0x3a, 
+  0x66, 0x61, 0x3a, 0x36, 0x39, 0x3a, 0x63, 0x32, 0x3a, 0x31, 0x34, 0x3a, 
+  0x64, 0x30, 0x3a, 0x66, 0x62, 0x3a, 0x34, 0x64, 0x3a, 0x35, 0x35, 0x3a, 
+  0x36, 0x62, 0x3a, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x36, 0x33, 0x3a, 0x35, 0x32, 0x3a, 0x62, 0x63, 0x3a, 0x63, 0x34, 
+  0x3a, 0x32, 0x33, 0x3a, 0x33, 0x34, 0x3a, 0x32, 0x63, 0x3a, 0x66, 0x32, 
+  0x3a, 0x37, 0x65, 0x3a, 0x66, 0x63, 0x3a, 0x34, 0x38, 0x3a, 0x30, 0x32, 
+  0x3a, 0x32, 0x37, 0x3a, 0x32, 0x33, 0x3a, 0x61, 0x63, 0x3a, 0x33, 0x32, 
+  0x3a, 0x31, 0x32, 0x3a, 0x38, 0x62, 0x3a, 0x0a, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x38, 0x33, 0x3a, 0x34, 0x63, 0x3a, 0x39, 
+  0x33, 0x3a, 0x64, 0x35, 0x3a, 0x32, 0x65, 0x3a, 0x39, 0x35, 0x3a, 0x35, 
+  0x35, 0x3a, 0x35, 0x36, 0x3a, 0x30, 0x65, 0x3a, 0x32, 0x33, 0x3a, 0x33, 
+  0x30, 0x3a, 0x35, 0x63, 0x3a, 0x61, 0x32, 0x3a, 0x65, 0x34, 0x3a, 0x66, 
+  0x62, 0x3a, 0x30, 0x65, 0x3a, 0x61, 0x33, 0x3a, 0x64, 0x64, 0x3a, 0x0a, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x39, 0x34, 0x3a, 
+  0x32, 0x61, 0x3a, 0x39, 0x38, 0x3a, 0x66, 0x34, 0x3a, 0x38, 0x63, 0x3a, 
+  0x33, 0x31, 0x3a, 0x62, 0x37, 0x3a, 0x61, 0x31, 0x3a, 0x35, 0x37, 0x3a, 
+  0x39, 0x37, 0x3a, 0x38, 0x35, 0x3a, 0x30, 0x31, 0x3a, 0x33, 0x35, 0x3a, 
+  0x66, 0x39, 0x3a, 0x39, 0x34, 0x3a, 0x39, 0x61, 0x3a, 0x32, 0x37, 0x3a, 
+  0x63, 0x35, 0x3a, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x64, 0x30, 0x3a, 0x30, 0x66, 0x3a, 0x32, 0x62, 0x3a, 0x30, 0x61, 
+  0x3a, 0x33, 0x39, 0x3a, 0x32, 0x34, 0x3a, 0x35, 0x38, 0x3a, 0x39, 0x61, 
+  0x3a, 0x62, 0x61, 0x3a, 0x32, 0x61, 0x3a, 0x31, 0x32, 0x3a, 0x64, 0x64, 
+  0x3a, 0x34, 0x62, 0x3a, 0x38, 0x66, 0x3a, 0x65, 0x65, 0x3a, 0x33, 0x34, 
+  0x3a, 0x36, 0x30, 0x3a, 0x66, 0x62, 0x3a, 0x0a, 0x20, 0x20, 0x20, 0x20, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x66, 0x32, 0x3a, 0x36, 0x36, 0x3a, 0x35, 
+  0x36, 0x3a, 0x34, 0x39, 0x3a, 0x37, 0x38, 0x3a, 0x33, 0x33, 0x3a, 0x61, 
+  0x33, 0x3a, 0x38, 0x38, 0x3a, 0x63, 0x63, 0x3a, 0x62, 0x61, 0x3a, 0x34, 
+  0x35, 0x3a, 0x30, 0x35, 0x3a, 0x64, 0x34, 0x3a, 0x31, 0x32, 0x3a, 0x32, 
+  0x35, 0x3a, 0x38, 0x34, 0x3a, 0x36, 0x63, 0x3a, 0x33, 0x38, 0x3a, 0x0a, 
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x36, 0x65, 0x3a, 
+  0x65, 0x64, 0x3a, 0x32, 0x38, 0x3a, 0x30, 0x31, 0x0a, 0x2d, 0x2d, 0x2d, 
+  0x2d, 0x2d, 0x42, 0x45, 0x47, 0x49, 0x4e, 0x20, 0x43, 0x45, 0x52, 0x54, 
+  0x49, 0x46, 0x49, 0x43, 0x41, 0x54, 0x45, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 
+  0x0a, 0x4d, 0x49, 0x49, 0x44, 0x45, 0x54, 0x43, 0x43, 0x41, 0x66, 0x6d, 
+  0x67, 0x41, 0x77, 0x49, 0x42, 0x41, 0x67, 0x49, 0x42, 0x41, 0x54, 0x41, 
+  0x4e, 0x42, 0x67, 0x6b, 0x71, 0x68, 0x6b, 0x69, 0x47, 0x39, 0x77, 0x30, 
+  0x42, 0x41, 0x51, 0x55, 0x46, 0x41, 0x44, 0x42, 0x72, 0x4d, 0x52, 0x41, 
+  0x77, 0x44, 0x67, 0x59, 0x44, 0x56, 0x51, 0x51, 0x44, 0x44, 0x41, 0x64, 
+  0x4d, 0x5a, 0x57, 0x64, 0x70, 0x0a, 0x64, 0x45, 0x4e, 0x42, 0x4d, 0x51, 
+  0x73, 0x77, 0x43, 0x51, 0x59, 0x44, 0x56, 0x51, 0x51, 0x49, 0x44, 0x41, 
+  0x4a, 0x45, 0x51, 0x7a, 0x45, 0x4c, 0x4d, 0x41, 0x6b, 0x47, 0x41, 0x31, 
+  0x55, 0x45, 0x42, 0x68, 0x4d, 0x43, 0x56, 0x56, 0x4d, 0x78, 0x48, 0x7a, 
+  0x41, 0x64, 0x42, 0x67, 0x6b, 0x71, 0x68, 0x6b, 0x69, 0x47, 0x39, 0x77, 
+  0x30, 0x42, 0x43, 0x51, 0x45, 0x57, 0x45, 0x48, 0x4a, 0x76, 0x0a, 0x62, 
+  0x33, 0x52, 0x41, 0x5a, 0x47, 0x56, 0x6d, 0x5a, 0x57, 0x35, 0x7a, 0x5a, 
+  0x53, 0x35, 0x6e, 0x62, 0x33, 0x59, 0x78, 0x44, 0x54, 0x41, 0x4c, 0x42, 
+  0x67, 0x4e, 0x56, 0x42, 0x41, 0x6f, 0x4d, 0x42, 0x45, 0x46, 0x6a, 0x62, 
+  0x57, 0x55, 0x78, 0x44, 0x54, 0x41, 0x4c, 0x42, 0x67, 0x4e, 0x56, 0x42, 
+  0x41, 0x73, 0x4d, 0x42, 0x45, 0x4a, 0x70, 0x65, 0x6c, 0x67, 0x77, 0x48, 
+  0x68, 0x63, 0x4e, 0x0a, 0x4d, 0x54, 0x59, 0x77, 0x4d, 0x7a, 0x49, 0x34, 
+  0x4d, 0x44, 0x55, 0x30, 0x4e, 0x7a, 0x4d, 0x33, 0x57, 0x68, 0x63, 0x4e, 
+  0x4d, 0x6a, 0x45, 0x77, 0x4d, 0x7a, 0x49, 0x33, 0x4d, 0x44, 0x55, 0x30, 
+  0x4e, 0x7a, 0x4d, 0x33, 0x57, 0x6a, 0x42, 0x73, 0x4d, 0x52, 0x45, 0x77, 
+  0x44, 0x77, 0x59, 0x44, 0x56, 0x51, 0x51, 0x44, 0x44, 0x41, 0x68, 0x4d, 
+  0x5a, 0x57, 0x64, 0x70, 0x64, 0x46, 0x4e, 0x32, 0x0a, 0x63, 0x6a, 0x45, 
+  0x4c, 0x4d, 0x41, 0x6b, 0x47, 0x41, 0x31, 0x55, 0x45, 0x43, 0x41, 0x77, 
+  0x43, 0x52, 0x45, 0x4d, 0x78, 0x43, 0x7a, 0x41, 0x4a, 0x42, 0x67, 0x4e, 
+  0x56, 0x42, 0x41, 0x59, 0x54, 0x41, 0x6c, 0x56, 0x54, 0x4d, 0x52, 0x38, 
+  0x77, 0x48, 0x51, 0x59, 0x4a, 0x4b, 0x6f, 0x5a, 0x49, 0x68, 0x76, 0x63, 
+  0x4e, 0x41, 0x51, 0x6b, 0x42, 0x46, 0x68, 0x42, 0x79, 0x62, 0x32, 0x39, 
+  0x30, 0x0a, 0x51, 0x47, 0x52, 0x6c, 0x5a, 0x6d, 0x56, 0x75, 0x63, 0x32, 
+  0x55, 0x75, 0x5a, 0x32, 0x39, 0x32, 0x4d, 0x51, 0x30, 0x77, 0x43, 0x77, 
+  0x59, 0x44, 0x56, 0x51, 0x51, 0x4b, 0x44, 0x41, 0x52, 0x42, 0x59, 0x32, 
+  0x31, 0x6c, 0x4d, 0x51, 0x30, 0x77, 0x43, 0x77, 0x59, 0x44, 0x56, 0x51, 
+  0x51, 0x4c, 0x44, 0x41, 0x52, 0x43, 0x61, 0x58, 0x70, 0x59, 0x4d, 0x49, 
+  0x47, 0x66, 0x4d, 0x41, 0x30, 0x47, 0x0a, 0x43, 0x53, 0x71, 0x47, 0x53, 
+  0x49, 0x62, 0x33, 0x44, 0x51, 0x45, 0x42, 0x41, 0x51, 0x55, 0x41, 0x41, 
+  0x34, 0x47, 0x4e, 0x41, 0x44, 0x43, 0x42, 0x69, 0x51, 0x4b, 0x42, 0x67, 
+  0x51, 0x43, 0x74, 0x51, 0x35, 0x55, 0x42, 0x69, 0x30, 0x70, 0x59, 0x32, 
+  0x61, 0x68, 0x63, 0x38, 0x76, 0x35, 0x41, 0x77, 0x77, 0x63, 0x57, 0x6f, 
+  0x2b, 0x34, 0x4f, 0x34, 0x54, 0x56, 0x64, 0x6c, 0x51, 0x4a, 0x52, 0x0a, 
+  0x53, 0x76, 0x45, 0x39, 0x41, 0x71, 0x6e, 0x39, 0x68, 0x4a, 0x33, 0x76, 
+  0x53, 0x44, 0x45, 0x38, 0x2f, 0x43, 0x66, 0x76, 0x36, 0x4b, 0x71, 0x76, 
+  0x67, 0x35, 0x6a, 0x46, 0x42, 0x77, 0x4b, 0x73, 0x58, 0x51, 0x56, 0x5a, 
+  0x38, 0x42, 0x44, 0x54, 0x2b, 0x56, 0x59, 0x6d, 0x6e, 0x72, 0x68, 0x67, 
+  0x39, 0x54, 0x56, 0x58, 0x4f, 0x54, 0x6d, 0x5a, 0x33, 0x56, 0x2b, 0x6b, 
+  0x6f, 0x6d, 0x49, 0x4d, 0x0a, 0x65, 0x30, 0x6c, 0x62, 0x48, 0x45, 0x2b, 
+  0x56, 0x65, 0x65, 0x74, 0x55, 0x62, 0x33, 0x5a, 0x6b, 0x77, 0x6c, 0x77, 
+  0x6a, 0x34, 0x56, 0x7a, 0x76, 0x68, 0x57, 0x57, 0x4b, 0x73, 0x2b, 0x4a, 
+  0x62, 0x30, 0x70, 0x59, 0x42, 0x30, 0x4c, 0x37, 0x4e, 0x35, 0x51, 0x2f, 
+  0x6b, 0x65, 0x68, 0x47, 0x47, 0x56, 0x5a, 0x35, 0x35, 0x55, 0x54, 0x69, 
+  0x49, 0x78, 0x6a, 0x4b, 0x6c, 0x2b, 0x67, 0x57, 0x42, 0x0a, 0x2f, 0x49, 
+  0x31, 0x71, 0x71, 0x64, 0x4b, 0x30, 0x6e, 0x51, 0x49, 0x44, 0x41, 0x51, 
+  0x41, 0x42, 0x6f, 0x30, 0x4d, 0x77, 0x51, 0x54, 0x41, 0x4a, 0x42, 0x67, 
+  0x4e, 0x56, 0x48, 0x52, 0x4d, 0x45, 0x41, 0x6a, 0x41, 0x41, 0x4d, 0x41, 
+  0x73, 0x47, 0x41, 0x31, 0x55, 0x64, 0x44, 0x77, 0x51, 0x45, 0x41, 0x77, 
+  0x49, 0x46, 0x34, 0x44, 0x41, 0x6e, 0x42, 0x67, 0x4e, 0x56, 0x48, 0x52, 
+  0x45, 0x45, 0x0a, 0x49, 0x44, 0x41, 0x65, 0x67, 0x67, 0x74, 0x6b, 0x5a, 
+  0x57, 0x5a, 0x6c, 0x62, 0x6e, 0x4e, 0x6c, 0x4c, 0x6d, 0x64, 0x76, 0x64, 
+  0x6f, 0x49, 0x50, 0x59, 0x57, 0x78, 0x30, 0x4c, 0x6d, 0x52, 0x6c, 0x5a, 
+  0x6d, 0x56, 0x75, 0x63, 0x32, 0x55, 0x75, 0x5a, 0x32, 0x39, 0x32, 0x4d, 
+  0x41, 0x30, 0x47, 0x43, 0x53, 0x71, 0x47, 0x53, 0x49, 0x62, 0x33, 0x44, 
+  0x51, 0x45, 0x42, 0x42, 0x51, 0x55, 0x41, 0x0a, 0x41, 0x34, 0x49, 0x42, 
+  0x41, 0x51, 0x42, 0x31, 0x44, 0x72, 0x79, 0x46, 0x34, 0x45, 0x42, 0x36, 
+  0x4d, 0x46, 0x79, 0x38, 0x37, 0x38, 0x5a, 0x51, 0x56, 0x58, 0x31, 0x46, 
+  0x4f, 0x7a, 0x4c, 0x36, 0x69, 0x30, 0x67, 0x4b, 0x34, 0x50, 0x46, 0x70, 
+  0x57, 0x69, 0x4b, 0x50, 0x44, 0x70, 0x55, 0x6e, 0x4b, 0x7a, 0x33, 0x58, 
+  0x6a, 0x70, 0x4b, 0x38, 0x45, 0x47, 0x33, 0x77, 0x69, 0x79, 0x45, 0x45, 
+  0x0a, 0x55, 0x37, 0x43, 0x74, 0x36, 0x71, 0x6a, 0x77, 0x53, 0x2b, 0x5a, 
+  0x76, 0x59, 0x44, 0x56, 0x64, 0x6e, 0x31, 0x70, 0x64, 0x43, 0x43, 0x75, 
+  0x77, 0x32, 0x59, 0x48, 0x31, 0x43, 0x52, 0x67, 0x61, 0x6b, 0x78, 0x75, 
+  0x52, 0x57, 0x42, 0x36, 0x5a, 0x67, 0x2f, 0x4c, 0x32, 0x30, 0x32, 0x44, 
+  0x48, 0x7a, 0x77, 0x48, 0x71, 0x48, 0x54, 0x7a, 0x46, 0x53, 0x6b, 0x4e, 
+  0x4c, 0x53, 0x69, 0x2b, 0x6a, 0x0a, 0x58, 0x6f, 0x2b, 0x39, 0x48, 0x70, 
+  0x59, 0x43, 0x61, 0x57, 0x74, 0x43, 0x32, 0x38, 0x64, 0x2f, 0x47, 0x31, 
+  0x67, 0x39, 0x44, 0x38, 0x62, 0x35, 0x6e, 0x50, 0x4b, 0x4d, 0x77, 0x42, 
+  0x50, 0x51, 0x73, 0x6b, 0x72, 0x76, 0x55, 0x61, 0x7a, 0x6b, 0x41, 0x47, 
+  0x69, 0x74, 0x2f, 0x76, 0x59, 0x50, 0x73, 0x4a, 0x56, 0x34, 0x55, 0x39, 
+  0x58, 0x31, 0x75, 0x78, 0x43, 0x6d, 0x76, 0x70, 0x4c, 0x4f, 0x0a, 0x76, 
+  0x36, 0x69, 0x77, 0x39, 0x4c, 0x59, 0x46, 0x78, 0x49, 0x41, 0x41, 0x6b, 
+  0x46, 0x2b, 0x59, 0x55, 0x30, 0x54, 0x36, 0x61, 0x63, 0x49, 0x55, 0x30, 
+  0x50, 0x74, 0x4e, 0x56, 0x57, 0x74, 0x6a, 0x55, 0x72, 0x7a, 0x45, 0x49, 
+  0x7a, 0x51, 0x73, 0x38, 0x6e, 0x37, 0x38, 0x53, 0x41, 0x49, 0x6e, 0x49, 
+  0x36, 0x77, 0x79, 0x45, 0x6f, 0x75, 0x44, 0x54, 0x4a, 0x50, 0x56, 0x4c, 
+  0x70, 0x56, 0x56, 0x0a, 0x56, 0x67, 0x34, 0x6a, 0x4d, 0x46, 0x79, 0x69, 
+  0x35, 0x50, 0x73, 0x4f, 0x6f, 0x39, 0x32, 0x55, 0x4b, 0x70, 0x6a, 0x30, 
+  0x6a, 0x44, 0x47, 0x33, 0x6f, 0x56, 0x65, 0x58, 0x68, 0x51, 0x45, 0x31, 
+  0x2b, 0x5a, 0x53, 0x61, 0x4a, 0x38, 0x58, 0x51, 0x44, 0x79, 0x73, 0x4b, 
+  0x4f, 0x53, 0x52, 0x59, 0x6d, 0x72, 0x6f, 0x71, 0x45, 0x74, 0x31, 0x4c, 
+  0x6a, 0x2b, 0x34, 0x30, 0x59, 0x50, 0x76, 0x79, 0x0a, 0x5a, 0x6c, 0x5a, 
+  0x4a, 0x65, 0x44, 0x4f, 0x6a, 0x69, 0x4d, 0x79, 0x36, 0x52, 0x51, 0x58, 
+  0x55, 0x45, 0x69, 0x57, 0x45, 0x62, 0x44, 0x68, 0x75, 0x37, 0x53, 0x67, 
+  0x42, 0x0a, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x45, 0x4e, 0x44, 0x20, 0x43, 
+  0x45, 0x52, 0x54, 0x49, 0x46, 0x49, 0x43, 0x41, 0x54, 0x45, 0x2d, 0x2d, 
+  0x2d, 0x2d, 0x2d, 0x0a, 
+};
+
+int _crtbuf_len = sizeof(_crtbuf);
+
+char _keybuf[] = {
+  0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x42, 0x45, 0x47, 0x49, 0x4e, 0x20, 0x52, 
+  0x53, 0x41, 0x20, 0x50, 0x52, 0x49, 0x56, 0x41, 0x54, 0x45, 0x20, 0x4b, 
+  0x45, 0x59, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x0a, 0x4d, 0x49, 0x49, 0x43, 
+  0x58, 0x51, 0x49, 0x42, 0x41, 0x41, 0x4b, 0x42, 0x67, 0x51, 0x43, 0x74, 
+  0x51, 0x35, 0x55, 0x42, 0x69, 0x30, 0x70, 0x59, 0x32, 0x61, 0x68, 0x63, 
+  0x38, 0x76, 0x35, 0x41, 0x77, 0x77, 0x63, 0x57, 0x6f, 0x2b, 0x34, 0x4f, 
+  0x34, 0x54, 0x56, 0x64, 0x6c, 0x51, 0x4a, 0x52, 0x53, 0x76, 0x45, 0x39, 
+  0x41, 0x71, 0x6e, 0x39, 0x68, 0x4a, 0x33, 0x76, 0x53, 0x44, 0x45, 0x38, 
+  0x0a, 0x2f, 0x43, 0x66, 0x76, 0x36, 0x4b, 0x71, 0x76, 0x67, 0x35, 0x6a, 
+  0x46, 0x42, 0x77, 0x4b, 0x73, 0x58, 0x51, 0x56, 0x5a, 0x38, 0x42, 0x44, 
+  0x54, 0x2b, 0x56, 0x59, 0x6d, 0x6e, 0x72, 0x68, 0x67, 0x39, 0x54, 0x56, 
+  0x58, 0x4f, 0x54, 0x6d, 0x5a, 0x33, 0x56, 0x2b, 0x6b, 0x6f, 0x6d, 0x49, 
+  0x4d, 0x65, 0x30, 0x6c, 0x62, 0x48, 0x45, 0x2b, 0x56, 0x65, 0x65, 0x74, 
+  0x55, 0x62, 0x33, 0x5a, 0x6b, 0x0a, 0x77, 0x6c, 0x77, 0x6a, 0x34, 0x56, 
+  0x7a, 0x76, 0x68, 0x57, 0x57, 0x4b, 0x73, 0x2b, 0x4a, 0x62, 0x30, 0x70, 
+  0x59, 0x42, 0x30, 0x4c, 0x37, 0x4e, 0x35, 0x51, 0x2f, 0x6b, 0x65, 0x68, 
+  0x47, 0x47, 0x56, 0x5a, 0x35, 0x35, 0x55, 0x54, 0x69, 0x49, 0x78, 0x6a, 
+  0x4b, 0x6c, 0x2b, 0x67, 0x57, 0x42, 0x2f, 0x49, 0x31, 0x71, 0x71, 0x64, 
+  0x4b, 0x30, 0x6e, 0x51, 0x49, 0x44, 0x41, 0x51, 0x41, 0x42, 0x0a, 0x41, 
+  0x6f, 0x47, 0x42, 0x41, 0x4a, 0x32, 0x53, 0x77, 0x75, 0x62, 0x65, 0x6d, 
+  0x4d, 0x54, 0x70, 0x58, 0x6a, 0x62, 0x36, 0x50, 0x73, 0x55, 0x44, 0x47, 
+  0x57, 0x55, 0x37, 0x76, 0x50, 0x73, 0x48, 0x55, 0x68, 0x4e, 0x44, 0x75, 
+  0x78, 0x48, 0x58, 0x69, 0x45, 0x47, 0x6d, 0x4e, 0x4a, 0x62, 0x39, 0x6a, 
+  0x75, 0x7a, 0x59, 0x79, 0x50, 0x37, 0x66, 0x6a, 0x43, 0x71, 0x68, 0x66, 
+  0x4f, 0x6d, 0x57, 0x0a, 0x55, 0x73, 0x2b, 0x4e, 0x4b, 0x70, 0x38, 0x37, 
+  0x45, 0x65, 0x7a, 0x54, 0x61, 0x56, 0x70, 0x2b, 0x66, 0x68, 0x30, 0x74, 
+  0x61, 0x42, 0x32, 0x31, 0x6f, 0x38, 0x57, 0x70, 0x30, 0x62, 0x5a, 0x74, 
+  0x41, 0x4a, 0x76, 0x49, 0x67, 0x4a, 0x58, 0x36, 0x65, 0x52, 0x33, 0x71, 
+  0x34, 0x6d, 0x6f, 0x4d, 0x42, 0x4c, 0x43, 0x43, 0x78, 0x65, 0x31, 0x67, 
+  0x54, 0x4a, 0x6e, 0x77, 0x42, 0x65, 0x39, 0x31, 0x0a, 0x48, 0x64, 0x38, 
+  0x2b, 0x50, 0x33, 0x69, 0x4e, 0x74, 0x33, 0x51, 0x7a, 0x73, 0x55, 0x42, 
+  0x4b, 0x64, 0x72, 0x74, 0x46, 0x48, 0x57, 0x73, 0x47, 0x59, 0x42, 0x6d, 
+  0x74, 0x70, 0x46, 0x6e, 0x44, 0x76, 0x42, 0x59, 0x4d, 0x55, 0x7a, 0x2f, 
+  0x73, 0x39, 0x71, 0x38, 0x61, 0x79, 0x51, 0x6e, 0x35, 0x41, 0x6b, 0x45, 
+  0x41, 0x34, 0x43, 0x53, 0x48, 0x62, 0x62, 0x35, 0x78, 0x73, 0x59, 0x2f, 
+  0x30, 0x0a, 0x51, 0x79, 0x41, 0x67, 0x38, 0x4a, 0x2b, 0x30, 0x51, 0x30, 
+  0x67, 0x6f, 0x74, 0x4f, 0x45, 0x57, 0x50, 0x46, 0x7a, 0x4b, 0x67, 0x58, 
+  0x64, 0x75, 0x70, 0x6e, 0x6b, 0x70, 0x5a, 0x64, 0x4a, 0x63, 0x33, 0x39, 
+  0x43, 0x38, 0x2f, 0x4c, 0x63, 0x54, 0x77, 0x30, 0x4c, 0x46, 0x34, 0x50, 
+  0x46, 0x74, 0x46, 0x2f, 0x34, 0x32, 0x7a, 0x52, 0x34, 0x2f, 0x66, 0x58, 
+  0x39, 0x70, 0x52, 0x52, 0x72, 0x38, 0x0a, 0x78, 0x49, 0x4b, 0x53, 0x4c, 
+  0x67, 0x6d, 0x32, 0x43, 0x77, 0x4a, 0x42, 0x41, 0x4d, 0x58, 0x6a, 0x30, 
+  0x70, 0x74, 0x67, 0x4c, 0x79, 0x46, 0x6a, 0x68, 0x4a, 0x75, 0x41, 0x32, 
+  0x76, 0x6b, 0x48, 0x54, 0x4b, 0x52, 0x64, 0x37, 0x6a, 0x75, 0x72, 0x41, 
+  0x34, 0x6d, 0x66, 0x5a, 0x79, 0x49, 0x7a, 0x6a, 0x71, 0x64, 0x62, 0x41, 
+  0x53, 0x2f, 0x33, 0x73, 0x4d, 0x45, 0x52, 0x4a, 0x63, 0x43, 0x4d, 0x0a, 
+  0x75, 0x50, 0x42, 0x76, 0x32, 0x4e, 0x59, 0x37, 0x34, 0x7a, 0x34, 0x74, 
+  0x39, 0x79, 0x64, 0x2f, 0x75, 0x31, 0x71, 0x37, 0x57, 0x78, 0x31, 0x61, 
+  0x41, 0x53, 0x49, 0x67, 0x4e, 0x39, 0x49, 0x32, 0x4d, 0x50, 0x63, 0x43, 
+  0x51, 0x46, 0x49, 0x6e, 0x63, 0x58, 0x41, 0x62, 0x44, 0x71, 0x63, 0x4c, 
+  0x59, 0x58, 0x63, 0x39, 0x44, 0x6e, 0x58, 0x44, 0x77, 0x35, 0x6d, 0x70, 
+  0x6d, 0x43, 0x6e, 0x38, 0x0a, 0x47, 0x6c, 0x39, 0x54, 0x6a, 0x33, 0x48, 
+  0x32, 0x71, 0x5a, 0x72, 0x67, 0x36, 0x2f, 0x69, 0x44, 0x4b, 0x30, 0x46, 
+  0x70, 0x79, 0x2b, 0x74, 0x41, 0x32, 0x30, 0x43, 0x46, 0x64, 0x2b, 0x76, 
+  0x6a, 0x38, 0x5a, 0x32, 0x4b, 0x73, 0x75, 0x46, 0x70, 0x78, 0x64, 0x47, 
+  0x6b, 0x34, 0x70, 0x76, 0x4f, 0x73, 0x58, 0x6b, 0x42, 0x64, 0x72, 0x7a, 
+  0x6a, 0x47, 0x46, 0x4d, 0x43, 0x51, 0x45, 0x4e, 0x62, 0x0a, 0x4e, 0x31, 
+  0x31, 0x68, 0x6b, 0x4d, 0x6b, 0x35, 0x6d, 0x58, 0x4a, 0x67, 0x6d, 0x71, 
+  0x66, 0x32, 0x33, 0x78, 0x52, 0x33, 0x55, 0x46, 0x61, 0x49, 0x38, 0x41, 
+  0x78, 0x51, 0x38, 0x49, 0x62, 0x49, 0x71, 0x37, 0x36, 0x31, 0x45, 0x43, 
+  0x4e, 0x6d, 0x6d, 0x49, 0x67, 0x75, 0x73, 0x50, 0x33, 0x6f, 0x4b, 0x43, 
+  0x37, 0x57, 0x73, 0x79, 0x54, 0x41, 0x66, 0x36, 0x6d, 0x7a, 0x64, 0x5a, 
+  0x50, 0x42, 0x0a, 0x4f, 0x32, 0x45, 0x33, 0x73, 0x6c, 0x79, 0x38, 0x50, 
+  0x50, 0x53, 0x44, 0x71, 0x4e, 0x78, 0x70, 0x53, 0x36, 0x4d, 0x43, 0x51, 
+  0x51, 0x43, 0x37, 0x78, 0x70, 0x45, 0x6e, 0x59, 0x4c, 0x2f, 0x4c, 0x75, 
+  0x75, 0x6e, 0x44, 0x30, 0x36, 0x67, 0x79, 0x42, 0x70, 0x39, 0x41, 0x76, 
+  0x41, 0x4d, 0x56, 0x4b, 0x6e, 0x5a, 0x59, 0x38, 0x4d, 0x31, 0x64, 0x36, 
+  0x74, 0x73, 0x6d, 0x6d, 0x32, 0x61, 0x52, 0x0a, 0x65, 0x69, 0x68, 0x52, 
+  0x62, 0x6f, 0x48, 0x65, 0x70, 0x4a, 0x32, 0x34, 0x41, 0x33, 0x48, 0x43, 
+  0x72, 0x45, 0x49, 0x6a, 0x61, 0x36, 0x35, 0x52, 0x72, 0x50, 0x2b, 0x67, 
+  0x4d, 0x75, 0x7a, 0x54, 0x6a, 0x42, 0x68, 0x4f, 0x61, 0x69, 0x59, 0x52, 
+  0x4d, 0x56, 0x6f, 0x49, 0x0a, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x45, 0x4e, 
+  0x44, 0x20, 0x52, 0x53, 0x41, 0x20, 0x50, 0x52, 0x49, 0x56, 0x41, 0x54, 
+  0x45, 0x20, 0x4b, 0x45, 0x59, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x0a, 
+};
+
+int _keybuf_len = sizeof(_keybuf);
+
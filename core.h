@@ -11,6 +11,8 @@
     #include <pty.h>
 #endif
 
+#include <cstdint>
+#include <cstdio>
 #include <string>
 #include <memory>
 #include <map>
@@ -26,9 +28,18 @@
 #define TPT_ERROR -2
 
 #define LOG_BUFSIZE 8192
+#define LOG_RINGSIZE (1 << 20)
+#define LOG_FLUSH_MS 50
 #define LOG_FILE (1<<1)
 #define LOG_ECHO (1<<2)
 
+#define LOG_LEVEL_TRACE 0               // per message / keystroke detail
+#define LOG_LEVEL_DEBUG 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_WARN 3
+#define LOG_LEVEL_ERROR 4
+#define LOG_LEVEL_OFF 5
+
 #define MSG_INVALID (0)
 #define MSG_RVSHELL (1)
 #define MSG_WNDSIZE (2)
@@ -37,6 +48,7 @@
 #define MSG_PROXY_FAIL (5)
 #define MSG_PROXY_DATA (6)
 #define MSG_PROXY_DEAD (7)
+#define MSG_POOL_MIN 256                // smallest pooled body size
 
 #ifndef MAX
 #define MAX(a, b) (a > b ? a : b)
@@ -50,12 +62,34 @@
 #define CLAMP(val, min, max) MAX(min, MIN(max, val))
 #endif
 
-#ifndef LOG_DISABLE
-#define LOG(...) log_print(__VA_ARGS__)
+// logging below the compile time minimum level is removed entirely (the 
+// arguments are still type checked), the rest is filtered at runtime
+#ifndef LOG_MIN_LEVEL
+#ifdef LOG_DISABLE
+#define LOG_MIN_LEVEL LOG_LEVEL_OFF
 #else
-#define LOG(...) 
+#define LOG_MIN_LEVEL LOG_LEVEL_TRACE
+#endif
 #endif
 
+#define LOG_ENABLED(level) \
+    ((level) >= LOG_MIN_LEVEL && (level) >= g_loglevel)
+
+#define LOG_AT(level, ...) \
+    do { if (LOG_ENABLED(level)) log_print(__VA_ARGS__); } while (0)
+
+#define LOG_TRACE(...) LOG_AT(LOG_LEVEL_TRACE, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_WARN(...) LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+
+#define LOG_HEXDUMP(level, buf, len) \
+    do { if (LOG_ENABLED(level)) hexdump(buf, len); } while (0)
+
+// runtime log level threshold
+extern int g_loglevel;
+
 // type proto
 class transport;
 class message;
@@ -63,8 +97,13 @@ class message;
 // func proto
 void log_init(const char * prefix, int flags);
 void log_flags(int flags = 0);
+void log_level(int level);
+int log_level_from_name(const char * name);
 void log_print(const char * fmt, ...);
-void hexdump(const char * buf, int len, int cols = 16, bool ascii = true); 
+void log_flush();
+void hexdump(const char * buf, int len, int cols = 16, bool ascii = true,
+             FILE * out = NULL);
+uint64_t time_now_us();
 
 ////////////////////////////////////////////////////////////////////////////////
 // abstract transport interface
@@ -78,26 +117,53 @@ public:
 
     // abstract interface
     virtual int init(int type) = 0;
-    virtual int send(message & msg) = 0;
+    virtual int send(message & msg, bool urgent = false) = 0;
     virtual int recv(message & msg) = 0;
     virtual void setopt(int opt, std::string value) = 0;
     virtual void close() = 0;
+
+    // event loop support, the fd to wait on for incoming data and the 
+    // number of bytes already read from it but not yet returned by recv
+    virtual int fd() { return -1; }
+    virtual int pending() { return 0; }
+
+    // outbound frames may be held back to be coalesced (unless urgent) or
+    // because the fd would block. flush() writes what is due (returning 
+    // the bytes left), flush_timeout() is the ms until more is due and
+    // wants_write() means the fd should also be polled for writability.
+    // congested() means the peer isn't keeping up, callers stop reading 
+    // new input to send until it clears rather than queue without limit
+    virtual int flush() { return 0; }
+    virtual int flush_timeout() { return -1; }
+    virtual bool wants_write() { return false; }
+    virtual bool congested() { return false; }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
-// transport message container
+// transport message container, a frame is the header followed by the body.
+// small bodies are stored inline, larger ones come from a buffer pool. the
+// body isn't initialised, call zero() if it needs to be. growing keeps the
+// bytes already in the buffer, up to its previous capacity
 
 class message {
 public:
 
     // class 
     enum { header_len = sizeof(int) * 2 }; 
-    enum { body_max_len = 1024 }; 
+    enum { body_max_len = 64 * 1024 }; 
+    enum { inline_len = 120 };
 
     // ctors / dtors
     message(int type = MSG_INVALID, size_t len = 0);
     message(int type, const char * buf, size_t len);
-    message(const char * buf, size_t len);
+    message(const message & other);
+    message & operator=(const message & other);
+    ~message();
+
+    // frame parsing, returns the frame length, 0 if more data is needed 
+    // or -1 if the header is invalid
+    static int frame_len(const char * buf, size_t len);
+    int load(const char * buf, size_t len);
 
     // buffer getters
     char * data();
@@ -110,15 +176,21 @@ public:
     // misc getters / setters
     int type() const;
     size_t resize(size_t len);
+    void zero();
 
 protected:
 
-    // internal data struct
-    struct {
+    // frame header at the start of the buffer
+    struct header {
         int type;
         int body_len;
-        char body[body_max_len];
-    } m_data;
+    };
+
+    header * m_hdr;                     // inline buffer or heap
+    size_t m_cap;                       // body capacity
+    int m_inline[(header_len + inline_len) / sizeof(int)];
+
+    void reserve(size_t len);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
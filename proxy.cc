@@ -61,14 +61,14 @@ int transport_proxy::enable(int s_port, std::string d_ip, int d_port) {
 
     // can only have one proxy route per port
     if (m_downstreams.find(s_port) != m_downstreams.end()) {
-        LOG("proxy: (error) already active for port %d\n", s_port);
+        LOG_WARN("proxy: (error) already active for port %d\n", s_port);
         return -1;
     }
 
     // bind tcp listener to desired port
     std::shared_ptr<tcp_stream> stream(new tcp_stream());
     if (stream->bind(s_port) < 0) {
-        LOG("proxy: unable to bind to port %d\n", s_port);
+        LOG_WARN("proxy: unable to bind to port %d\n", s_port);
         return -1;
     }
 
@@ -82,7 +82,7 @@ int transport_proxy::enable(int s_port, std::string d_ip, int d_port) {
     m_headers[s_port] = header;
     m_downstreams[s_port] = stream;
     m_state[s_port] = PROXY_LISTENING;
-    LOG("proxy: adding route[%d] %s:%d to %s:%d\n", 
+    LOG_DEBUG("proxy: adding route[%d] %s:%d to %s:%d\n", 
         stream->sock(), stream->src_ip(), s_port, d_ip.c_str(), d_port);
 
     return 0;
@@ -92,43 +92,47 @@ int transport_proxy::enable(int s_port, std::string d_ip, int d_port) {
 // remove a proxy route for a given port
 
 void transport_proxy::disable(int s_port) {
-    LOG("proxy: removing route (port %d)\n", s_port);
+    LOG_DEBUG("proxy: removing route (port %d)\n", s_port);
     m_downstreams.erase(s_port);
     m_headers.erase(s_port);
     m_state.erase(s_port);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// helper func - build fd_set of proxy sockets that need polling
+// list the proxy sockets that need polling for incoming data
 
-void transport_proxy::build_sockset(fd_set & socks, int & fd_max) {
+void transport_proxy::socks(std::vector<int> & out) {
 
-    // add downstreams to socket set
+    // add downstreams to socket list
     for (auto & kv : m_downstreams) {
         std::shared_ptr<tcp_stream> & stream = kv.second;
-        int sock = stream->sock();
         int s_port = stream->src_port();
 
         // add listener socks to check for incoming connections
         if (m_state[s_port] == PROXY_LISTENING) {
-            fd_max = MAX(fd_max, sock);
-            FD_SET(sock, &socks);
+            out.push_back(stream->sock());
         
         // add client socks to check for incoming data
         } else if (m_state[s_port] == PROXY_ESTABLISHED) {
             for (int sock : stream->client_socks()) {
-                fd_max = MAX(fd_max, sock);
-                FD_SET(sock, &socks);
+                out.push_back(sock);
             }
         }
     }
 
-    // add upstreams to socket set
+    // add upstreams to check for incoming data
     for (auto & kv : m_upstreams) {
-        std::shared_ptr<tcp_stream> & stream = kv.second;
-        int sock = stream->sock();
+        out.push_back(kv.second->sock());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - build fd_set of proxy sockets that need polling
 
-        // add sock to check for incoming data
+void transport_proxy::build_sockset(fd_set & socks, int & fd_max) {
+    std::vector<int> list;
+    this->socks(list);
+    for (int sock : list) {
         fd_max = MAX(fd_max, sock);
         FD_SET(sock, &socks);
     }
@@ -153,7 +157,7 @@ int transport_proxy::dispatch_data(transport & tpt, int sock, int s_port,
         tpt.send(msg);
         
         // an error occurred or the connection was closed
-        LOG("proxy: error reading (%d) [err %d]\n", sock, bytes_ready);
+        LOG_WARN("proxy: error reading (%d) [err %d]\n", sock, bytes_ready);
         this->close(s_port);
 
         return -1;
@@ -168,7 +172,7 @@ int transport_proxy::dispatch_data(transport & tpt, int sock, int s_port,
 
     // TODO: move this into a get_header func for centralised error handling
     if (header.get() == NULL) {
-        LOG("proxy: invalid header for port %d\n", s_port);
+        LOG_WARN("proxy: invalid header for port %d\n", s_port);
         return -1;
     }
 
@@ -191,7 +195,7 @@ int transport_proxy::dispatch_data(transport & tpt, int sock, int s_port,
 
         // relay proxy msg to remote system
         if (tpt.send(msg) < 0) {
-            LOG("proxy: failed to dispatch message (port %d)\n", s_port);
+            LOG_WARN("proxy: failed to dispatch message (port %d)\n", s_port);
             return -1;
         }
     }
@@ -218,14 +222,14 @@ int transport_proxy::poll(transport & tpt, int timeout_ms) {
     // poll status of socket set
     if (select(fd_max + 1, &socks, 0, 0, &tv) < 0) {
         if (errno != EINTR) {
-            LOG("proxy: failed to poll socket set\n");
+            LOG_WARN("proxy: failed to poll socket set\n");
             // TODO: add handling to close problem sockets and try again
             //       otherwise they will never be removed and will ruin
             //       any attempt to continue handling other proxy streams
             for (int i = 0; i < fd_max; i++) {
                 struct stat sb;
                 if (fstat(i, &sb) < 0) {
-                    LOG("select: sock (%d) %s\n", i, strerror(errno));
+                    LOG_WARN("select: sock (%d) %s\n", i, strerror(errno));
                 }
             }
         }
@@ -248,7 +252,7 @@ int transport_proxy::poll(transport & tpt, int timeout_ms) {
 
                 // update state of proxy connection
                 m_state[s_port] = PROXY_PENDING;
-                LOG("proxy: client connected (%d) on port (%d)\n", 
+                LOG_DEBUG("proxy: client connected (%d) on port (%d)\n", 
                         client_sock, s_port);
                 
                 // establish proxy connection upstream
@@ -312,8 +316,8 @@ int transport_proxy::handle_msg(transport & tpt, message & msg) {
             *port = s_port;
 
             if (sock < 0) {
-                LOG("proxy: upstream connection to %s:%d failed for (%d)\n",
-                    header->d_ip, d_port, s_port); 
+                LOG_WARN("proxy: upstream connection to %s:%d failed "
+                         "for (%d)\n", header->d_ip, d_port, s_port); 
                 err = -1;
             } else {
     
@@ -326,7 +330,7 @@ int transport_proxy::handle_msg(transport & tpt, message & msg) {
                 // add upstream and it's header to proxy
                 m_headers[d_port] = new_header;
                 m_upstreams[d_port] = stream;
-                LOG("proxy: new upstream connection to %s:%d for (%d)\n",
+                LOG_DEBUG("proxy: new upstream connection to %s:%d for (%d)\n",
                     header->d_ip, d_port, s_port); 
             }
 
@@ -337,13 +341,14 @@ int transport_proxy::handle_msg(transport & tpt, message & msg) {
         case MSG_PROXY_PASS: {
             int s_port = *((int*)msg.body());
             m_state[s_port] = PROXY_ESTABLISHED;
-            LOG("proxy: upstream connection established (port %d)\n", s_port);
+            LOG_DEBUG("proxy: upstream connection established (port %d)\n", 
+                      s_port);
             break;
         }
         
         case MSG_PROXY_FAIL: {
             int s_port = *((int*)msg.body());
-            LOG("proxy: upstream connection failed (port %d)\n", s_port);
+            LOG_WARN("proxy: upstream connection failed (port %d)\n", s_port);
             this->close(s_port);
             break;
         }
@@ -359,11 +364,11 @@ int transport_proxy::handle_msg(transport & tpt, message & msg) {
 
             // check that the message relates to a valid route
             if (m_downstreams.find(d_port) != m_downstreams.end()) {
-                LOG("proxy: delivering downstream data to %d\n", d_port);
+                LOG_DEBUG("proxy: delivering downstream data to %d\n", d_port);
                 bytes = m_downstreams[d_port]->send(buf, len); 
 
             } else if (m_upstreams.find(d_port) != m_upstreams.end()) {
-                LOG("proxy: delivering upstream data to %d\n", d_port);
+                LOG_DEBUG("proxy: delivering upstream data to %d\n", d_port);
                 bytes = m_upstreams[d_port]->send(buf, len); 
             }
 
@@ -374,7 +379,7 @@ int transport_proxy::handle_msg(transport & tpt, message & msg) {
 
             // if proxy dies, close any associated local connections
             int port = *((int*)msg.body());
-            LOG("proxy: informed of proxy death (%d)\n", port); 
+            LOG_DEBUG("proxy: informed of proxy death (%d)\n", port); 
             this->close(port);
             break;
         }
@@ -393,16 +398,16 @@ void transport_proxy::close(int s_port) {
             m_upstreams.erase(s_port);
             m_headers.erase(s_port);
             m_state.erase(s_port); // upstreams don't have state atm
-            LOG("proxy: closed upstream (port %d)\n", s_port);
+            LOG_DEBUG("proxy: closed upstream (port %d)\n", s_port);
         }
         if (m_downstreams.find(s_port) != m_downstreams.end()) {
             m_state[s_port] = PROXY_LISTENING;
             m_downstreams[s_port]->disconnect_clients();
-            LOG("proxy: closed downstream (port %d)\n", s_port);
+            LOG_DEBUG("proxy: closed downstream (port %d)\n", s_port);
         }
 
     } else {
-        LOG("proxy: shutting down, closing all streams\n");
+        LOG_DEBUG("proxy: shutting down, closing all streams\n");
         m_downstreams.clear();
         m_upstreams.clear();
         m_headers.clear();
@@ -426,7 +431,7 @@ tcp_proxy::~tcp_proxy() {
 int tcp_proxy::bind(int s_port) {
 
     // bind to local port
-    LOG("proxy: binding to port %d\n", s_port);
+    LOG_DEBUG("proxy: binding to port %d\n", s_port);
     if (m_downstream.bind(s_port) < 0) {
         this->close();
         return -1;
@@ -443,14 +448,14 @@ int tcp_proxy::establish(std::string d_ip, int d_port) {
     u_len = d_len = 0;
 
     // wait for client connection
-    LOG("proxy: waiting for connection\n");
+    LOG_DEBUG("proxy: waiting for connection\n");
     if ((d_sock = m_downstream.accept()) < 0) {
         this->close();
         return -1;
     }
 
     // establish downstream connection
-    LOG("proxy: connecting downstream %s:%d\n", d_ip.c_str(), d_port);
+    LOG_DEBUG("proxy: connecting downstream %s:%d\n", d_ip.c_str(), d_port);
     if ((u_sock = m_upstream.connect(d_ip, d_port)) < 0) {
         this->close();
         return -1;
@@ -538,7 +543,7 @@ int tcp_proxy::poll() {
 ////////////////////////////////////////////////////////////////////////////////
 
 void tcp_proxy::close() {
-    LOG("proxy: closing connections\n");
+    LOG_DEBUG("proxy: closing connections\n");
     m_active = false;
     m_upstream.close();
     m_downstream.close();
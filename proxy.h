@@ -5,6 +5,8 @@
 #ifndef proxy_h
 #define proxy_h
 
+#include <vector>
+
 #include "core.h"
 #include "sock.h" 
 
@@ -26,6 +28,7 @@ public:
     void disable(int s_port);
 
     int poll(transport & tpt, int timeout_ms = 0);
+    void socks(std::vector<int> & out);
     int handle_msg(transport & tpt, message & msg);
     void close(int s_port = -1);
 
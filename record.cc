@@ -0,0 +1,333 @@
+////////////////////////////////////////////////////////////////////////////////
+// record.cc
+// author: jcramb@gmail.com
+
+#include <stdlib.h>
+#include <time.h>
+
+#include <cstring>
+#include <cstdio>
+
+#include "core.h"
+#include "record.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - length of the utf-8 sequence starting with c (0 if invalid)
+
+static int utf8_len(unsigned char c) {
+    if (c < 0x80) return 1;
+    if (c >= 0xc2 && c <= 0xdf) return 2;
+    if (c >= 0xe0 && c <= 0xef) return 3;
+    if (c >= 0xf0 && c <= 0xf4) return 4;
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - check the first n bytes of a sequence started by s[0]. the
+// second byte range rules out overlong forms, surrogates and values past
+// U+10FFFF, the same as the decoder in vterm_put_utf8
+
+static bool utf8_valid(const unsigned char * s, int n) {
+    for (int i = 1; i < n; i++) {
+        if ((s[i] & 0xc0) != 0x80) return false;
+    }
+    if (n < 2) return true;
+    switch (s[0]) {
+        case 0xe0: return s[1] >= 0xa0;
+        case 0xed: return s[1] <= 0x9f;
+        case 0xf0: return s[1] >= 0x90;
+        case 0xf4: return s[1] <= 0x8f;
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - append a code point to a string as utf-8
+
+static void utf8_append(std::string & out, unsigned cp) {
+    if (cp < 0x80) {
+        out += (char)cp;
+    } else if (cp < 0x800) {
+        out += (char)(0xc0 | (cp >> 6));
+        out += (char)(0x80 | (cp & 0x3f));
+    } else if (cp < 0x10000) {
+        out += (char)(0xe0 | (cp >> 12));
+        out += (char)(0x80 | ((cp >> 6) & 0x3f));
+        out += (char)(0x80 | (cp & 0x3f));
+    } else {
+        out += (char)(0xf0 | (cp >> 18));
+        out += (char)(0x80 | ((cp >> 12) & 0x3f));
+        out += (char)(0x80 | ((cp >> 6) & 0x3f));
+        out += (char)(0x80 | (cp & 0x3f));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - append bytes as a json string, json strings must be valid
+// utf-8 so bytes that aren't part of a valid sequence become U+FFFD. returns
+// the number of bytes consumed, an incomplete sequence at the end is left
+
+static int json_escape(std::string & out, const char * buf, int len) {
+    static const char hex[] = "0123456789abcdef";
+    int i = 0;
+    while (i < len) {
+        unsigned char c = buf[i];
+
+        // plain ascii, escaping quotes and control chars
+        if (c < 0x80) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (c < 0x20 || c == 0x7f) {
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xf];
+            } else {
+                out += c;
+            }
+            i++;
+            continue;
+        }
+
+        // multi byte sequence, wait for the rest if it's cut short
+        const unsigned char * s = (const unsigned char *)buf + i;
+        int n = utf8_len(c);
+        int avail = (i + n > len) ? len - i : n;
+        bool valid = (n > 0 && utf8_valid(s, avail));
+        if (valid && avail < n) break;
+        if (valid) {
+            out.append(buf + i, n);
+            i += n;
+        } else {
+            out += "\\ufffd";
+            i++;
+        }
+    }
+    return i;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - parse a json string at p, returns the char after it or NULL
+
+static const char * json_unescape(const char * p, std::string & out) {
+    out.clear();
+    if (*p++ != '"') return NULL;
+    while (*p && *p != '"') {
+        if (*p != '\\') {
+            out += *p++;
+            continue;
+        }
+        p++;
+        switch (*p) {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                char digits[5] = {0};
+                strncpy(digits, p + 1, 4);
+                if (strspn(digits, "0123456789abcdefABCDEF") != 4) {
+                    return NULL;
+                }
+                unsigned cp = strtoul(digits, NULL, 16);
+                p += 4;
+
+                // characters outside the bmp are sent as surrogate pairs
+                if (cp >= 0xd800 && cp <= 0xdbff &&
+                    p[1] == '\\' && p[2] == 'u') {
+                    strncpy(digits, p + 3, 4);
+                    unsigned lo = strtoul(digits, NULL, 16);
+                    if (strspn(digits, "0123456789abcdefABCDEF") == 4 &&
+                        lo >= 0xdc00 && lo <= 0xdfff) {
+                        cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+                        p += 6;
+                    }
+                }
+                utf8_append(out, cp);
+                break;
+            }
+            case '\0': return NULL;
+            default: out += *p; break;
+        }
+        p++;
+    }
+    return (*p == '"') ? p + 1 : NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - skip whitespace and an expected separator
+
+static const char * json_skip(const char * p, char sep) {
+    while (*p == ' ' || *p == '\t') p++;
+    if (*p != sep) return NULL;
+    p++;
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// recorder ctors / dtors
+
+session_recorder::session_recorder() {
+    m_file = NULL;
+    m_start_us = 0;
+}
+
+session_recorder::~session_recorder() {
+    close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// create recording and write the header
+
+int session_recorder::open(const char * path, int rows, int cols) {
+    close();
+    m_file = fopen(path, "w");
+    if (m_file == NULL) {
+        return -1;
+    }
+    m_start_us = time_now_us();
+    fprintf(m_file, "{\"version\": 2, \"width\": %d, \"height\": %d, "
+            "\"timestamp\": %ld, \"env\": {\"TERM\": \"xterm\"}}\n",
+            cols, rows, (long)time(NULL));
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// close recording
+
+void session_recorder::close() {
+    if (m_file == NULL) return;
+    if (!m_partial.empty()) {
+        write_event(REC_OUTPUT, "", 0);
+    }
+    fclose(m_file);
+    m_file = NULL;
+    m_partial.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// record terminal output
+
+void session_recorder::output(const char * buf, int len) {
+    if (m_file == NULL || len <= 0) return;
+    write_event(REC_OUTPUT, buf, len);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// record terminal resize
+
+void session_recorder::resize(int rows, int cols) {
+    if (m_file == NULL) return;
+    char size[32];
+    int len = snprintf(size, sizeof(size), "%dx%d", cols, rows);
+    write_event(REC_RESIZE, size, len);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - write one event line, stdio buffers the file writes
+
+void session_recorder::write_event(char code, const char * buf, int len) {
+    char prefix[64];
+    uint64_t elapsed = time_now_us() - m_start_us;
+    snprintf(prefix, sizeof(prefix), "[%llu.%06llu, \"%c\", \"",
+             (unsigned long long)(elapsed / 1000000),
+             (unsigned long long)(elapsed % 1000000), code);
+    m_line = prefix;
+
+    if (code == REC_OUTPUT) {
+
+        // a sequence cut short last time is completed by this read, the
+        // remainder is flushed as replacement chars when closing
+        m_partial.append(buf, len);
+        int used = json_escape(m_line, m_partial.data(), m_partial.size());
+        if (len == 0) {
+            while (used < (int)m_partial.size()) {
+                m_line += "\\ufffd";
+                used++;
+            }
+        }
+        m_partial.erase(0, used);
+    } else {
+        json_escape(m_line, buf, len);
+    }
+
+    m_line += "\"]\n";
+    fwrite(m_line.data(), 1, m_line.size(), m_file);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// player ctors / dtors
+
+session_player::session_player() {
+    m_file = NULL;
+    m_line = NULL;
+    m_line_len = 0;
+    m_rows = m_cols = 0;
+}
+
+session_player::~session_player() {
+    close();
+    free(m_line);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// open recording and read the header
+
+int session_player::open(const char * path) {
+    close();
+    m_file = fopen(path, "r");
+    if (m_file == NULL) {
+        return -1;
+    }
+
+    // header is a json object on the first line, only the size is used
+    if (getline(&m_line, &m_line_len, m_file) < 0 || m_line[0] != '{') {
+        close();
+        return -1;
+    }
+    const char * width = strstr(m_line, "\"width\"");
+    const char * height = strstr(m_line, "\"height\"");
+    if (width != NULL) m_cols = atoi(strchr(width, ':') + 1);
+    if (height != NULL) m_rows = atoi(strchr(height, ':') + 1);
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// close recording
+
+void session_player::close() {
+    if (m_file != NULL) {
+        fclose(m_file);
+    }
+    m_file = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// read the next event, lines that don't parse are skipped
+
+bool session_player::next(double & time, char & code, std::string & data) {
+    std::string event_code;
+    while (m_file != NULL && getline(&m_line, &m_line_len, m_file) >= 0) {
+        const char * p = json_skip(m_line, '[');
+        if (p == NULL) continue;
+
+        char * end;
+        time = strtod(p, &end);
+        if (end == p) continue;
+
+        p = json_skip(end, ',');
+        if (p == NULL) continue;
+        p = json_unescape(p, event_code);
+        if (p == NULL || event_code.size() != 1) continue;
+        code = event_code[0];
+
+        p = json_skip(p, ',');
+        if (p == NULL) continue;
+        p = json_unescape(p, data);
+        if (p == NULL) continue;
+        return true;
+    }
+    return false;
+}
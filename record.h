@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////
+// record.h
+// author: jcramb@gmail.com
+
+#ifndef record_h
+#define record_h
+
+#include <stdint.h>
+#include <cstdio>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+// defines
+
+#define REC_OUTPUT 'o'                  // bytes the terminal rendered
+#define REC_RESIZE 'r'                  // terminal resized, data is "COLSxROWS"
+
+////////////////////////////////////////////////////////////////////////////////
+// session recorder, writes terminal output in asciicast v2 format (a json
+// header line then one [time, code, data] event per line) so recordings
+// also play back in asciinema
+
+class session_recorder {
+public:
+
+    // ctors / dtors
+    session_recorder();
+    ~session_recorder();
+
+    // file handling
+    int open(const char * path, int rows, int cols);
+    void close();
+    bool is_open() const { return m_file != NULL; }
+
+    // events
+    void output(const char * buf, int len);
+    void resize(int rows, int cols);
+
+protected:
+    FILE * m_file;
+    uint64_t m_start_us;
+    std::string m_line;
+    std::string m_partial;              // utf-8 sequence split across reads
+
+    void write_event(char code, const char * buf, int len);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// session player, reads back asciicast v2 events in order
+
+class session_player {
+public:
+
+    // ctors / dtors
+    session_player();
+    ~session_player();
+
+    // file handling
+    int open(const char * path);
+    void close();
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+
+    // get the next event, returns false at the end of the recording
+    bool next(double & time, char & code, std::string & data);
+
+protected:
+    FILE * m_file;
+    char * m_line;
+    size_t m_line_len;
+    int m_rows, m_cols;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // record_h
@@ -11,17 +11,30 @@
 #include <ctype.h>
 #include <poll.h>
 #include <pwd.h>
+#include <langinfo.h>
 
 #include <cstdlib>
 #include <csignal>
+#include <clocale>
 #include <cstring>
 #include <climits>
 #include <cstdio>
+#include <vector>
+#include <string>
 
 #include "core.h"
 #include "vterm.h"
 #include "ssl.h"
 #include "proxy.h"
+#include "trace.h"
+#include "record.h"
+
+#define TTY_DEFAULT_FPS 60
+#define TTY_SCROLLBACK_LINES 100000
+#define TTY_SCROLLBACK_BYTES (64 << 20)
+#define TTY_KEY_HANDLED (-2)
+#define TTY_INPUT_MAX (16 << 10)        // translated keys sent per frame
+#define TPT_RECV_MAX (64 << 10)         // bytes handled per wakeup
 
 ////////////////////////////////////////////////////////////////////////////////
 // wrapper class for vt100 terminal emulator using modified libvterm
@@ -30,19 +43,51 @@ class terminal {
 public:
 
     // ctors / dtors
-    terminal() {}
+    terminal();
     ~terminal() {}
 
     // tty emulator i/o
     int init(int * rows = NULL, int * cols = NULL);
     int get_key(char * buf, int len);
+    int get_input(std::string & buf);
     int render(const char * buf, int len);
+    int flush();
+    int paint_timeout();
     void resize(int * rows = NULL, int * cols = NULL);
     void exit();
+
+    // repaint rate limit (0 = paint on every render)
+    void set_fps(int fps);
+
+    // paint with escape sequences written straight to stdout instead of 
+    // through curses (must be set before init)
+    void set_ansi(bool enable) { m_use_ansi = enable; }
+
+    // cap the emulator size below the window (0 = no cap), applied on the 
+    // next resize() so recordings play back at the size they were made
+    void set_max_size(int rows, int cols) {
+        m_max_rows = rows;
+        m_max_cols = cols;
+    }
+
+    // view scrollback history (positive is back in time, 0 returns to live)
+    void scroll_view(int lines);
     
 protected:
     WINDOW * wnd;
     vterm_t * vterm;
+    vterm_ansi_t * m_ansi;
+    bool m_use_ansi;
+    bool m_paste;                       // local bracketed paste enabled
+    int m_max_rows, m_max_cols;         // size cap, 0 follows the window
+
+    // repaint scheduling
+    bool m_pending;
+    uint64_t m_frame_us;
+    uint64_t m_last_paint;
+
+    int paint(bool force);
+    void set_paste(bool enable);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -56,14 +101,139 @@ message & mk_resize_msg(int rows, int cols) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// handle window resize signals
+// helper function to send a message, recording it if tracing. all of the
+// server's own messages are interactive so they aren't held back
+
+int send_msg(transport & tpt, trace_writer & trace, message & msg) {
+    trace.record(TRACE_TX, msg.type(), msg.body(), msg.body_len());
+    return tpt.send(msg, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper function to combine poll timeouts (-1 is no timeout)
+
+int min_timeout(int a, int b) {
+    if (a < 0) return b;
+    if (b < 0) return a;
+    return MIN(a, b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper function to create poll entries waiting for incoming data
+
+struct pollfd mk_pollfd(int fd) {
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return pfd;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// handle window resize signals, only flagged here. curses isn't safe to call
+// from a signal handler, the next get_key() picks up the new size instead
 
-void handle_winch(int sig)
+static volatile sig_atomic_t g_winch = 0;
+
+void handle_winch(int)
 {
-    endwin();
-    refresh();
-    clear();
-    LOG(">> SIGWINCH\n");
+    g_winch = 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// replay a recorded session through the terminal emulator, at the recorded
+// pace or as fast as possible, which times parsing and painting end to end
+
+int replay(terminal & tty, const char * path, bool fast) {
+    session_player player;
+    if (player.open(path) < 0) {
+        LOG_ERROR("fatal: unable to read recording '%s'\n", path);
+        return -1;
+    }
+
+    // setup tty emulation, only keys are read during playback
+    tty.init();
+    signal(SIGWINCH, handle_winch);
+    log_flags(LOG_FILE);
+    LOG_INFO("info: replaying '%s' (%dx%d)\n", path, 
+             player.rows(), player.cols());
+
+    // play back at the recorded size, clamped to the window
+    tty.set_max_size(player.rows(), player.cols());
+    tty.resize();
+
+    double time;
+    char code;
+    std::string data;
+    char buf[256];
+    int keycode;
+    bool running = true;
+    uint64_t bytes = 0;
+    uint64_t events = 0;
+    uint64_t start = time_now_us();
+    while (running && player.next(time, code, data)) {
+        if (code != REC_OUTPUT && code != REC_RESIZE) continue;
+
+        // wait until the event is due, handling keys and held back paints
+        // ('q' stops playback, scrollback keys work as usual)
+        uint64_t due = start + (uint64_t)(time * 1000000);
+        uint64_t now;
+        while (!fast && running && (now = time_now_us()) < due) {
+            int timeout = (due - now + 999) / 1000;
+            if (tty.paint_timeout() >= 0) {
+                timeout = MIN(timeout, tty.paint_timeout());
+            }
+            struct pollfd pfd = mk_pollfd(STDIN_FILENO);
+            poll(&pfd, 1, timeout);
+            while ((keycode = tty.get_key(buf, sizeof(buf))) != ERR) {
+                if (keycode == 'q') running = false;
+                if (keycode == KEY_RESIZE) tty.resize();
+            }
+            if (tty.paint_timeout() == 0) {
+                tty.flush();
+            }
+        }
+        if (!running) break;
+
+        // later output is laid out for the new size ("COLSxROWS")
+        if (code == REC_RESIZE) {
+            int rows, cols;
+            if (sscanf(data.c_str(), "%dx%d", &cols, &rows) == 2 &&
+                rows > 0 && cols > 0) {
+                tty.set_max_size(rows, cols);
+                tty.resize();
+            }
+            continue;
+        }
+
+        tty.render(data.data(), data.size());
+        bytes += data.size();
+        events++;
+    }
+    tty.flush();
+    uint64_t elapsed = MAX(time_now_us() - start, (uint64_t)1);
+
+    // keep the final screen up until 'q' when watching
+    while (!fast && running) {
+        struct pollfd pfd = mk_pollfd(STDIN_FILENO);
+        poll(&pfd, 1, -1);
+        while ((keycode = tty.get_key(buf, sizeof(buf))) != ERR) {
+            if (keycode == 'q') running = false;
+            if (keycode == KEY_RESIZE) tty.resize();
+        }
+        tty.flush();
+    }
+    tty.exit();
+
+    // report throughput, meaningful when replaying as fast as possible
+    double mb = bytes / (1024.0 * 1024.0);
+    LOG_INFO("info: replayed %llu events, %.1f MB in %.3f s (%.1f MB/s)\n",
+             (unsigned long long)events, mb, elapsed / 1e6, 
+             mb / (elapsed / 1e6));
+    printf("replayed %llu events, %.1f MB in %.3f s (%.1f MB/s)\n",
+           (unsigned long long)events, mb, elapsed / 1e6, 
+           mb / (elapsed / 1e6));
+    return 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -77,125 +247,295 @@ int main(int argc, char **argv) {
     int read_count = 0;
     int write_count = 0;
     int proxy_count = 0;
+    trace_writer trace;
+    session_recorder rec;
+    const char * rec_path = NULL;
+    const char * replay_path = NULL;
+    bool replay_fast = false;
     int rows, cols;
+    int opt;
 
     // initialise debug log
     log_init(argv[0], LOG_FILE | LOG_ECHO);
 
+    // parse options, the remaining args are positional
+    while ((opt = getopt(argc, argv, "l:t:r:p:fah")) != -1) {
+        switch (opt) {
+            case 'l':
+                if (log_level_from_name(optarg) < 0) {
+                    fprintf(stderr, "invalid log level '%s'\n", optarg);
+                    exit(-1);
+                }
+                log_level(log_level_from_name(optarg));
+                break;
+            case 't': 
+                if (trace.open(optarg) < 0) {
+                    LOG_ERROR("fatal: unable to create trace file '%s'\n", 
+                              optarg);
+                    exit(-1);
+                }
+                LOG_INFO("info: tracing messages to '%s'\n", optarg);
+                break;
+            case 'r': rec_path = optarg; break;
+            case 'p': replay_path = optarg; break;
+            case 'f': replay_fast = true; break;
+            case 'a': tty.set_ansi(true); break;
+            default:
+                fprintf(stderr, "usage: %s [-a] [-l level] [-t trace] "
+                        "[-r rec] [port] [fps]\n"
+                        "       %s [-a] [-f] -p rec [fps]\n", 
+                        argv[0], argv[0]);
+                exit(-1);
+        }
+    }
+    argc -= optind - 1;
+    argv += optind - 1;
+
+    // replay a recording instead of waiting for a client
+    if (replay_path != NULL) {
+        if (argc > 1) {
+            tty.set_fps(atoi(argv[1]));
+        }
+        return replay(tty, replay_path, replay_fast);
+    }
+
     // set host port if required
     if (argc > 1) {
         ssl.setopt(SSL_OPT_PORT, argv[1]);
     }
+
+    // set repaint rate limit if required
+    if (argc > 2) {
+        tty.set_fps(atoi(argv[2]));
+    }
     
     // initialise proxy from file
     proxy.init_from_file(".proxies");
     
     // wait for reverse shell to connect via SSL (blocking)
     if (tpt.init(TPT_SERVER) < 0) {
-        LOG("fatal: failed to establish transport connection\n");
+        LOG_ERROR("fatal: failed to establish transport connection\n");
         exit(-1);
     }
     
     // setup tty emulation and retrieve size of terminal window
     tty.init(&rows, &cols);
     signal(SIGWINCH, handle_winch);
+
+    // start recording terminal output if required
+    if (rec_path != NULL) {
+        if (rec.open(rec_path, rows, cols) < 0) {
+            tty.exit();
+            LOG_ERROR("fatal: unable to create recording '%s'\n", rec_path);
+            exit(-1);
+        }
+        LOG_INFO("info: recording session to '%s'\n", rec_path);
+    }
     
     // disable echo for logging since we're in a curses window now
     log_flags(LOG_FILE);
 
     // resize client shell to server terminal size
-    LOG("info: sending resize to client (%dx%d)\n", rows, cols);
-    tpt.send(mk_resize_msg(rows, cols));
+    LOG_INFO("info: sending resize to client (%dx%d)\n", rows, cols);
+    send_msg(tpt, trace, mk_resize_msg(rows, cols));
 
     // start server loop
     int keycode;
-    char buf[256];
-    LOG("info: starting loop...\n");
-    while (1) {
-        
-        // check for shell output from client shell (non-blocking)
-        message msg;
-        int bytes = tpt.recv(msg);
-        if (bytes == TPT_CLOSE) {
-            LOG("fatal: client disconnected\n");
-            break;
-        } else if (bytes == TPT_ERROR) {
-            LOG("fatal: transport failure\n");
+    std::string input;
+    bool running = true;
+    std::vector<struct pollfd> fds;
+    std::vector<int> proxy_socks;
+    message msg; // reused for every received frame, keeps its buffer
+    LOG_INFO("info: starting loop...\n");
+    while (running) {
+
+        // wait on the transport, keyboard and proxy sockets, only waking up
+        // early for a repaint held back by the frame rate limit or queued
+        // proxy traffic that is due to be sent. data that openssl already 
+        // decrypted won't wake poll, so don't wait for it. output blocked 
+        // by the socket waits for the transport to become writable, and
+        // while the client isn't keeping up keys and proxy data are left 
+        // unread so nothing more is queued
+        bool congested = tpt.congested();
+        fds.clear();
+        fds.push_back(mk_pollfd(tpt.fd()));
+        if (tpt.wants_write()) {
+            fds[0].events |= POLLOUT;
+        }
+        fds.push_back(mk_pollfd(STDIN_FILENO));
+        if (congested) {
+            fds[1].events = 0;
+        }
+        proxy_socks.clear();
+        if (!congested) {
+            proxy.socks(proxy_socks);
+        }
+        for (int sock : proxy_socks) {
+            fds.push_back(mk_pollfd(sock));
+        }
+        int timeout = min_timeout(tty.paint_timeout(), tpt.flush_timeout());
+        if (tpt.pending() > 0) {
+            timeout = 0;
+        }
+        if (timeout != 0) {
+            trace.flush();
+        }
+        int ready = poll(fds.data(), fds.size(), timeout);
+        if (ready < 0 && errno != EINTR) {
+            LOG_ERROR("fatal: poll failed (%s)\n", strerror(errno));
             break;
-        } else if (bytes != TPT_EMPTY) {
-
-            // handle message based on type
-            switch (msg.type()) {
-
-                case MSG_RVSHELL: {
-            
-                    // log output to file
-                    LOG("RD: [%04d] %d bytes\n", read_count++, msg.body_len());
-                    hexdump(msg.body(), msg.body_len());
-
-                    // render output in tty emulator
-                    tty.render(msg.body(), msg.body_len());
-                    break;
-                } 
-
-                case MSG_PROXY_INIT:
-                case MSG_PROXY_PASS:
-                case MSG_PROXY_FAIL:
-                case MSG_PROXY_DATA: 
-                case MSG_PROXY_DEAD: {
-                    LOG("PROXY: [%04d] %d bytes\n", proxy_count++, bytes);
-                    hexdump(msg.body(), msg.body_len());
-                    proxy.handle_msg(ssl, msg);
-                    break;
-                }
-            }
         }
 
-        // check for input from tty emulator (non-blocking)
-        if ((keycode = tty.get_key(buf, sizeof(buf))) != ERR) {
-
-            // log tty input to file
-            if (isprint(keycode)) {
-                LOG("WR: [%04d] %3d '%c'\n", write_count++, keycode, keycode);
+        // check for shell output from client shell. a client that never 
+        // pauses (yes, cat bigfile) would keep this busy forever, so stop 
+        // after a budget and let keys, proxies and the paint have a turn. 
+        // whatever is left makes the next poll return straight away
+        int recv_bytes = 0;
+        bool tpt_ready = (fds[0].revents & ~POLLOUT) != 0;
+        while (running && recv_bytes < TPT_RECV_MAX &&
+               (tpt_ready || tpt.pending() > 0)) {
+            int bytes = tpt.recv(msg);
+            if (bytes == TPT_CLOSE) {
+                LOG_ERROR("fatal: client disconnected\n");
+                running = false;
+            } else if (bytes == TPT_ERROR) {
+                LOG_ERROR("fatal: transport failure\n");
+                running = false;
+            } else if (bytes == TPT_EMPTY) {
+                break;
             } else {
-                LOG("WR: [%04d] %3d ''\n", write_count++, keycode);
+                recv_bytes += bytes;
+
+                // handle message based on type, the trace replaces the 
+                // hexdump in the log when enabled
+                trace.record(TRACE_RX, msg.type(), msg.body(), msg.body_len());
+                switch (msg.type()) {
+
+                    case MSG_RVSHELL: {
+                
+                        // log output to file
+                        LOG_TRACE("RD: [%04d] %d bytes\n", 
+                            read_count++, msg.body_len());
+                        if (!trace.is_open()) {
+                            LOG_HEXDUMP(LOG_LEVEL_TRACE, 
+                                        msg.body(), msg.body_len());
+                        }
+
+                        // parse output in tty emulator (rate limited paint)
+                        rec.output(msg.body(), msg.body_len());
+                        tty.render(msg.body(), msg.body_len());
+                        break;
+                    } 
+
+                    case MSG_PROXY_INIT:
+                    case MSG_PROXY_PASS:
+                    case MSG_PROXY_FAIL:
+                    case MSG_PROXY_DATA: 
+                    case MSG_PROXY_DEAD: {
+                        LOG_TRACE("PROXY: [%04d] %d bytes\n", 
+                                  proxy_count++, (int)msg.body_len());
+                        if (!trace.is_open()) {
+                            LOG_HEXDUMP(LOG_LEVEL_TRACE, 
+                                        msg.body(), msg.body_len());
+                        }
+                        proxy.handle_msg(ssl, msg);
+                        break;
+                    }
+                }
             }
+        }
+        if (!running) break;
+
+        // check for input from tty emulator, curses may have buffered more 
+        // than one key (a paste is thousands) and a signal (SIGWINCH) 
+        // interrupts poll, so drain it. the keys are sent as one frame
+        if (!congested && (fds[1].revents || ready < 0)) {
+            do {
+                keycode = tty.get_input(input);
+                if (!input.empty()) {
+
+                    // log tty input to file
+                    LOG_TRACE("WR: [%04d] %d bytes\n", 
+                              write_count++, (int)input.size());
+                    if (!trace.is_open()) {
+                        LOG_HEXDUMP(LOG_LEVEL_TRACE, 
+                                    input.data(), input.size());
+                    }
+
+                    // send tty input to client shell
+                    message key(MSG_RVSHELL, input.data(), input.size());
+                    send_msg(tpt, trace, key);
+                }
 
-            // handle ncurses telling us about a resize
-            if (keycode == KEY_RESIZE) {
-
-                // first resize the terminal emulator
-                int rows, cols;
-                tty.resize(&rows, &cols);
+                // handle ncurses telling us about a resize
+                if (keycode == KEY_RESIZE) {
 
-                // tell the client about the resize
-                LOG("info: sending resize to client (%dx%d)\n", rows, cols);
-                tpt.send(mk_resize_msg(rows, cols));      
+                    // first resize the terminal emulator
+                    int rows, cols;
+                    tty.resize(&rows, &cols);
+                    rec.resize(rows, cols);
 
-            } else {
+                    // tell the client about the resize
+                    LOG_INFO("info: sending resize to client (%dx%d)\n", 
+                             rows, cols);
+                    send_msg(tpt, trace, mk_resize_msg(rows, cols));
+                }
+            } while (keycode != ERR);
+        }
 
-                // send tty input to client shell
-                message msg(MSG_RVSHELL, strlen(buf));
-                memcpy(msg.body(), buf, strlen(buf));
-                tpt.send(msg);
+        // handle proxy traffic routing when any of its sockets are ready
+        for (size_t i = 2; i < fds.size(); i++) {
+            if (fds[i].revents) {
+                proxy.poll(ssl);
+                break;
             }
         }
 
-        // handle proxy traffic routing
-        proxy.poll(ssl);
+        // write out queued messages that are due or couldn't be sent yet
+        if (tpt.flush() < 0) {
+            LOG_ERROR("fatal: transport failure\n");
+            break;
+        }
+
+        // paint output held back by the frame rate limit once it's due
+        if (tty.paint_timeout() == 0) {
+            tty.flush();
+        }
     }
 
     // tear down terminal emulation and reset window
     tty.exit();
-    LOG("info: server shutdown\n");
+    LOG_INFO("info: server shutdown\n");
     return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// terminal ctors / dtors
+
+terminal::terminal() {
+    wnd = NULL;
+    vterm = NULL;
+    m_ansi = NULL;
+    m_use_ansi = false;
+    m_paste = false;
+    m_max_rows = m_max_cols = 0;
+    m_pending = false;
+    m_last_paint = 0;
+    set_fps(TTY_DEFAULT_FPS);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // setup tty emulation in curses window
 
 int terminal::init(int * in_rows, int * in_cols) {
 
+    // curses only draws wide chars in a utf-8 locale, which is assumed
+    // when the environment's locale isn't
+    if (setlocale(LC_ALL, "") == NULL ||
+        strcmp(nl_langinfo(CODESET), "UTF-8") != 0) {
+        setlocale(LC_CTYPE, "C.UTF-8");
+    }
+
     // setup ncurses
     initscr();
     start_color();
@@ -210,15 +550,23 @@ int terminal::init(int * in_rows, int * in_cols) {
     getmaxyx(stdscr, rows, cols);
     if (in_rows != NULL) *in_rows = rows;
     if (in_cols != NULL) *in_cols = cols;
-    LOG("info: max tty size is %dx%d\n", rows, cols);
-
-    // create ncurses window
-    wnd = newwin(rows, cols, 0, 0);
-    wrefresh(wnd);
+    LOG_INFO("info: max tty size is %dx%d\n", rows, cols);
 
     // create terminal emulator
     vterm = vterm_create(cols, rows, 0); //VTERM_FLAG_VT100);
-    vterm_wnd_set(vterm, wnd);
+
+    // paint into an ncurses window, or keep curses for keyboard input only
+    // and let the ansi backend diff and write frames itself
+    if (m_use_ansi) {
+        refresh();
+        m_ansi = vterm_ansi_create(STDOUT_FILENO, rows, cols);
+        vterm_set_backend(vterm, &vterm_ansi_backend, m_ansi);
+    } else {
+        wnd = newwin(rows, cols, 0, 0);
+        wrefresh(wnd);
+        vterm_wnd_set(vterm, wnd);
+    }
+    vterm_set_scrollback(vterm, TTY_SCROLLBACK_LINES, TTY_SCROLLBACK_BYTES);
     return 0;
 }
 
@@ -228,7 +576,29 @@ int terminal::init(int * in_rows, int * in_cols) {
 
 int terminal::get_key(char * buf, int len) {
     memset(buf, 0, len);
+
+    // restarting curses after a resize signal makes it read the new window 
+    // size, getch() then returns KEY_RESIZE
+    if (g_winch) {
+        g_winch = 0;
+        endwin();
+        refresh();
+        clear();
+        LOG_DEBUG(">> SIGWINCH\n");
+    }
     int ch = getch();
+
+    // shift + page up / down scroll the history locally (half a page)
+    if (ch == KEY_SPREVIOUS || ch == KEY_SNEXT) {
+        int rows = getmaxy(stdscr) / 2;
+        scroll_view(ch == KEY_SPREVIOUS ? MAX(rows, 1) : -MAX(rows, 1));
+        return TTY_KEY_HANDLED;
+    }
+
+    // any other key goes to the shell, so show the live screen again
+    if (ch != ERR && ch != KEY_RESIZE) {
+        scroll_view(0);
+    }
     if (0) { // vt100 rendering
         switch (ch) {
             case '\n':           strcpy(buf, "\r");      break;
@@ -292,14 +662,89 @@ int terminal::get_key(char * buf, int len) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// emulate terminal functions and update curses window
+// read every key curses has buffered, translated, into one buffer. stops at 
+// a resize (returning KEY_RESIZE) so it's handled in order, returns OK when 
+// the buffer is full and ERR once all input has been read
+
+int terminal::get_input(std::string & buf) {
+    char key[16];
+    int ch;
+    buf.clear();
+    while (buf.size() < TTY_INPUT_MAX) {
+        ch = get_key(key, sizeof(key));
+        if (ch == ERR || ch == KEY_RESIZE) return ch;
+        if (ch != TTY_KEY_HANDLED) buf += key;
+    }
+    return OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// emulate terminal functions, the curses window is repainted at most once
+// per frame interval so parsing can keep up with bursts of output
 
 int terminal::render(const char * buf, int len) {
     vterm_remote_read(vterm, buf, len);
-    vterm_wnd_update(vterm);
-    touchwin(wnd);
-    wrefresh(wnd);
-    return 0;
+    set_paste(vterm_get_bracketed_paste(vterm));
+    m_pending = true;
+    return paint(false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// repaint any output that was held back by the frame rate limit
+
+int terminal::flush() {
+    return paint(true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// milliseconds until held back output is due to be painted, -1 if none
+
+int terminal::paint_timeout() {
+    if (!m_pending) return -1;
+
+    uint64_t due = m_last_paint + m_frame_us;
+    uint64_t now = time_now_us();
+    if (now >= due) return 0;
+    return (int)((due - now + 999) / 1000);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// update curses window from the emulator if a repaint is due
+
+int terminal::paint(bool force) {
+    if (!m_pending) return 0;
+
+    uint64_t now = time_now_us();
+    if (!force && now - m_last_paint < m_frame_us) return 0;
+
+    vterm_update(vterm);
+    if (wnd != NULL) {
+        wrefresh(wnd);
+    }
+    m_last_paint = now;
+    m_pending = false;
+    return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// set maximum number of repaints per second
+
+void terminal::set_fps(int fps) {
+    m_frame_us = (fps > 0) ? 1000000 / fps : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// move the view through scrollback history and repaint straight away
+
+void terminal::scroll_view(int lines) {
+    if (lines == 0) {
+        if (vterm_get_view_offset(vterm) == 0) return;
+        vterm_scroll_view_reset(vterm);
+    } else {
+        vterm_scroll_view(vterm, lines);
+    }
+    m_pending = true;
+    paint(true);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -308,9 +753,29 @@ int terminal::render(const char * buf, int len) {
 void terminal::resize(int * in_rows, int * in_cols) {
     int rows, cols;
     getmaxyx(stdscr, rows, cols);
+    bool capped = (m_max_rows > 0 && m_max_rows < rows) ||
+                  (m_max_cols > 0 && m_max_cols < cols);
+    if (m_max_rows > 0) rows = MIN(rows, m_max_rows);
+    if (m_max_cols > 0) cols = MIN(cols, m_max_cols);
     vterm_resize(vterm, cols, rows);
-    vterm_wnd_update(vterm);
-    wrefresh(wnd);
+    if (m_ansi != NULL) {
+        vterm_ansi_resize(m_ansi, rows, cols);
+        vterm_touch(vterm);
+        vterm_update(vterm);
+    } else {
+
+        // blank what a smaller window no longer covers
+        if (capped) {
+            werase(stdscr);
+            wnoutrefresh(stdscr);
+        }
+        wresize(wnd, rows, cols);
+        vterm_update(vterm);
+        touchwin(wnd);
+        wrefresh(wnd);
+    }
+    m_last_paint = time_now_us();
+    m_pending = false;
     if (in_rows != NULL) *in_rows = rows;
     if (in_cols != NULL) *in_cols = cols;
 }
@@ -319,8 +784,29 @@ void terminal::resize(int * in_rows, int * in_cols) {
 // clean up tty emulator / curses
 
 void terminal::exit() {
-    delwin(wnd);
+    set_paste(false);
+    if (m_ansi != NULL) {
+        vterm_set_backend(vterm, NULL, NULL);
+        vterm_ansi_destroy(m_ansi);
+        m_ansi = NULL;
+    }
+    if (wnd != NULL) {
+        delwin(wnd);
+        wnd = NULL;
+    }
     endwin();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// mirror the remote's bracketed paste mode (DEC 2004) on the real terminal,
+// so pastes arrive marked with ESC[200~ / ESC[201~ only when the shell on 
+// the other end asked for them. the markers pass through get_key untouched
+
+void terminal::set_paste(bool enable) {
+    if (enable == m_paste) return;
+    const char * seq = enable ? "\e[?2004h" : "\e[?2004l";
+    if (write(STDOUT_FILENO, seq, strlen(seq)) < 0) return;
+    m_paste = enable;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -103,10 +103,10 @@ int tcp_stream::send(const char * buf, int len, int sock) {
         sock = m_sock;
     } else if (m_type == SOCK_SERVER) {
         if (sock == m_sock) {
-            LOG("error: attempt to send over server listening sock!\n");
+            LOG_ERROR("error: attempt to send over server listening sock!\n");
             return -1;
         } else if (sock <= 0 && m_client_socks.size() > 1) {
-            LOG("error: attempt to send over invalid sock (%d)\n", sock);
+            LOG_ERROR("error: attempt to send over invalid sock (%d)\n", sock);
             return -1;
         } else if (m_client_socks.size() == 1) {
             sock = *m_client_socks.begin();
@@ -117,7 +117,7 @@ int tcp_stream::send(const char * buf, int len, int sock) {
     while (bytes_sent < len) {
         int bytes = ::send(sock, buf + bytes_sent, len - bytes_sent, 0);
         if (bytes < 0) {
-            LOG("error: (send)[%d] %s\n", sock, strerror(errno));
+            LOG_ERROR("error: (send)[%d] %s\n", sock, strerror(errno));
             break;
         }
         bytes_sent += bytes;
@@ -133,13 +133,13 @@ int tcp_stream::recv(char * buf, int len, int sock) {
     if (m_type == SOCK_CLIENT) {
         sock = m_sock;
     } else if (m_type == SOCK_SERVER && sock <= 0) {
-        LOG("error: attempt to recv over invalid sock (%d)\n", sock);
+        LOG_ERROR("error: attempt to recv over invalid sock (%d)\n", sock);
         return -1;
     }
 
     int bytes = ::recv(sock, buf, len, 0);
     if (bytes < 0) {
-        LOG("error: (recv)[%d] (%s)\n", sock, strerror(errno));
+        LOG_ERROR("error: (recv)[%d] (%s)\n", sock, strerror(errno));
         return -1;
     }
 
@@ -150,7 +150,8 @@ int tcp_stream::recv(char * buf, int len, int sock) {
 // clean up stream details
 
 void tcp_stream::close(int sock) {
-    LOG("tcp_stream: socket closed [m_sock %2d | sock %2d]\n", m_sock, sock);
+    LOG_DEBUG("tcp_stream: socket closed [m_sock %2d | sock %2d]\n", 
+              m_sock, sock);
 
     // are we closing a client socket?
     if (m_client_socks.find(sock) != m_client_socks.end()) {
@@ -176,7 +177,7 @@ void tcp_stream::close(int sock) {
     
     // we may be trying to close an already closed socket if we get here
     } else {
-        LOG("error: attempt to close invalid socket (%d)\n", sock);
+        LOG_ERROR("error: attempt to close invalid socket (%d)\n", sock);
     }
 }
 
@@ -200,7 +201,7 @@ int tcp_stream::connect(std::string host, int port) {
     
     // obtain address info for server
     if ((ai_result = getaddrinfo(host.c_str(), _port, &hints, &server)) != 0) {
-        LOG("error: %s\n", gai_strerror(ai_result));
+        LOG_ERROR("error: %s\n", gai_strerror(ai_result));
         return -1;
     }
 
@@ -211,13 +212,13 @@ int tcp_stream::connect(std::string host, int port) {
         if ((m_sock = socket(index->ai_family,
                              index->ai_socktype,
                              index->ai_protocol)) < 0) {
-            LOG("error: (socket) %s\n", strerror(errno));
+            LOG_ERROR("error: (socket) %s\n", strerror(errno));
             continue;
         } 
 
         // connect to server using new socket
         if (::connect(m_sock, index->ai_addr, index->ai_addrlen) < 0) {
-            LOG("error: (connect) %s\n", strerror(errno));
+            LOG_ERROR("error: (connect) %s\n", strerror(errno));
             this->close();
             continue;
         }
@@ -232,13 +233,13 @@ int tcp_stream::connect(std::string host, int port) {
         struct sockaddr_in sin;
         socklen_t len = sizeof(sin);
         if (getsockname(m_sock, (struct sockaddr *)&sin, &len) < 0) {
-            LOG("error: getsockname (%s)\n", strerror(errno));
+            LOG_ERROR("error: getsockname (%s)\n", strerror(errno));
         }
         int s_port = ntohs(sin.sin_port);
 
         // success!
         m_type = SOCK_CLIENT;
-        LOG("info: [%d] connected to %s:%d\n", m_sock, addr_str, port); 
+        LOG_INFO("info: [%d] connected to %s:%d\n", m_sock, addr_str, port); 
         std::shared_ptr<sock_info> si;
         si.reset(new sock_info(sock_get_ip(), s_port, addr_str, port));
         m_sockinfo[m_sock] = si;
@@ -255,7 +256,7 @@ int tcp_stream::connect(std::string host, int port) {
 
 void tcp_stream::conn_limit(int limit) {
     if (m_type != SOCK_SERVER) {
-        LOG("error: conn_limit invalid on non-server streams\n");
+        LOG_ERROR("error: conn_limit invalid on non-server streams\n");
     } else {
         m_connlimit = limit;
     }
@@ -279,7 +280,7 @@ int tcp_stream::broadcast(const char * buf, int len) {
 
     // verify that this is a server stream 
     if (m_type != SOCK_SERVER) {
-        LOG("error: broadcast on a non-server tcp stream\n");
+        LOG_ERROR("error: broadcast on a non-server tcp stream\n");
         return -1;
     }
 
@@ -287,7 +288,8 @@ int tcp_stream::broadcast(const char * buf, int len) {
     for (auto sock : m_client_socks) {
         int bytes = this->send(buf, len, sock);
         if (bytes < 0) {
-            LOG("error: broadcast failed for sock (%d)[%d]\n", sock, bytes);
+            LOG_ERROR("error: broadcast failed for sock (%d)[%d]\n", 
+                      sock, bytes);
             err = bytes;
         }
     }
@@ -315,7 +317,7 @@ int tcp_stream::bind(int port) {
     
     // obtain address info for server port
     if ((ai_result = getaddrinfo(NULL, _port, &hints, &ai)) != 0) {
-        LOG("error:: %s\n", gai_strerror(ai_result));
+        LOG_ERROR("error:: %s\n", gai_strerror(ai_result));
         return -1;
     }
 
@@ -326,7 +328,7 @@ int tcp_stream::bind(int port) {
         if ((m_sock = socket(index->ai_family,
                              index->ai_socktype,
                              index->ai_protocol)) < 0) {
-            LOG("error: (socket) %s\n", strerror(errno));
+            LOG_ERROR("error: (socket) %s\n", strerror(errno));
             continue;
         } 
 
@@ -336,13 +338,13 @@ int tcp_stream::bind(int port) {
 
         // bind socket to server port
         if (::bind(m_sock, index->ai_addr, index->ai_addrlen) < 0) {
-            LOG("error: (bind) %s\n", strerror(errno));
+            LOG_ERROR("error: (bind) %s\n", strerror(errno));
             continue;
         } 
 
         // start listening for connections
         if (::listen(m_sock, SOCKET_BACKLOG) < 0) {
-            LOG("error: (listen) %s\n", strerror(errno));
+            LOG_ERROR("error: (listen) %s\n", strerror(errno));
             this->close();
             continue;
         } 
@@ -376,7 +378,7 @@ int tcp_stream::poll_accept(int timeout_ms) {
 
     // sanity check
     if (m_type != SOCK_SERVER) {
-        LOG("error: poll_accept on non-server stream! (%d)\n", m_sock);
+        LOG_ERROR("error: poll_accept on non-server stream! (%d)\n", m_sock);
         return -1;
     }
 
@@ -387,7 +389,7 @@ int tcp_stream::poll_accept(int timeout_ms) {
     if (retval <= 0 && errno == EINTR) {
         return 0;
     } else if (retval <= 0) {
-        LOG("error: poll failed (%s)\n", strerror(errno));
+        LOG_ERROR("error: poll failed (%s)\n", strerror(errno));
         return -1;
     }
 
@@ -412,13 +414,13 @@ int tcp_stream::accept() {
 
     // check that we're respecting the connection limit
     if (m_connlimit != -1 && m_client_socks.size() >= m_connlimit) {
-        LOG("error: connlimit rejection (%d)\n", m_sock);
+        LOG_ERROR("error: connlimit rejection (%d)\n", m_sock);
         return SOCK_LIMIT;
     }
 
     // wait for client to connect
     if ((client_sock = ::accept(m_sock, (struct sockaddr*)&client, &len)) < 0) {
-      LOG("error: (accept) %s\n", strerror(errno));
+      LOG_ERROR("error: (accept) %s\n", strerror(errno));
       return -1;
     }
 
@@ -430,7 +432,7 @@ int tcp_stream::accept() {
 
     int s_port = m_sockinfo[m_sock]->s_port;
     int d_port = ntohs(((struct sockaddr_in*)&client)->sin_port); 
-    LOG("info: connection %s:%d to %s:%d\n", 
+    LOG_INFO("info: connection %s:%d to %s:%d\n", 
             client_ip, d_port, src_ip(), src_port()); 
 
     // success!
@@ -449,7 +451,7 @@ int tcp_stream::accept() {
 const sock_info * tcp_stream::sockinfo(int sock) {
     if (sock == -1) sock = m_sock;
     if (m_sockinfo.find(sock) == m_sockinfo.end()) {
-        LOG("error: (sockinfo) invalid sock\n");
+        LOG_ERROR("error: (sockinfo) invalid sock\n");
         return NULL;
     }
     return m_sockinfo[sock].get();
@@ -458,7 +460,7 @@ const sock_info * tcp_stream::sockinfo(int sock) {
 const char * tcp_stream::src_ip(int sock) {
     if (sock == -1) sock = m_sock;
     if (m_sockinfo.find(sock) == m_sockinfo.end()) {
-        LOG("error: (src_ip) invalid sock\n");
+        LOG_ERROR("error: (src_ip) invalid sock\n");
         return NULL;
     }
     return m_sockinfo[sock]->s_ip;
@@ -467,7 +469,7 @@ const char * tcp_stream::src_ip(int sock) {
 const char * tcp_stream::dst_ip(int sock) {
     if (sock == -1) sock = m_sock;
     if (m_sockinfo.find(sock) == m_sockinfo.end()) {
-        LOG("error: (dst_ip) invalid sock\n");
+        LOG_ERROR("error: (dst_ip) invalid sock\n");
         return NULL;
     }
     return m_sockinfo[sock]->d_ip;
@@ -476,7 +478,7 @@ const char * tcp_stream::dst_ip(int sock) {
 int tcp_stream::src_port(int sock) {
     if (sock == -1) sock = m_sock;
     if (m_sockinfo.find(sock) == m_sockinfo.end()) {
-        LOG("error: (src_port) invalid sock\n");
+        LOG_ERROR("error: (src_port) invalid sock\n");
         return -1;
     }
     return m_sockinfo[sock]->s_port;
@@ -485,7 +487,7 @@ int tcp_stream::src_port(int sock) {
 int tcp_stream::dst_port(int sock) {
     if (sock == -1) sock = m_sock;
     if (m_sockinfo.find(sock) == m_sockinfo.end()) {
-        LOG("error: (dst_port) invalid sock\n");
+        LOG_ERROR("error: (dst_port) invalid sock\n");
         return -1;
     }
     return m_sockinfo[sock]->d_port;
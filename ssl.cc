@@ -13,6 +13,7 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <netdb.h>
+#include <poll.h>
 
 #include <openssl/ssl.h>
 #include <openssl/err.h>
@@ -36,25 +37,29 @@ int ssl_load_cert_bufs(SSL_CTX * ctx, char * crt_buf, int crt_len,
     BIO * cbio = BIO_new_mem_buf(crt_buf, -1);
     X509 * cert = PEM_read_bio_X509(cbio, NULL, 0, NULL);
 
-    // load key into openssl memory buffer
+    // load key into openssl memory buffer (RSA or ECDSA)
     BIO * kbio = BIO_new_mem_buf(key_buf, -1);
-    RSA * key = PEM_read_bio_RSAPrivateKey(kbio, NULL, 0, NULL);
+    EVP_PKEY * key = PEM_read_bio_PrivateKey(kbio, NULL, 0, NULL);
     
     // perform verification
+    int err = 0;
     if (SSL_CTX_use_certificate(ctx, cert) <= 0) {
-        LOG("error: openssl failed to load certificate buffer\n"); 
-        return -1;
-    }
-    if (SSL_CTX_use_RSAPrivateKey(ctx, key) <= 0) {
-        LOG("error: openssl failed to load key buffer\n"); 
-        return -1;
-    }
-    if (!SSL_CTX_check_private_key(ctx)) {
-        LOG("error: private key does not match public certificate\n");
-        return -1;
+        LOG_ERROR("error: openssl failed to load certificate buffer\n"); 
+        err = -1;
+    } else if (SSL_CTX_use_PrivateKey(ctx, key) <= 0) {
+        LOG_ERROR("error: openssl failed to load key buffer\n"); 
+        err = -1;
+    } else if (!SSL_CTX_check_private_key(ctx)) {
+        LOG_ERROR("error: private key does not match public certificate\n");
+        err = -1;
     }
 
-    return 0;
+    // the context holds its own references
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    BIO_free(cbio);
+    BIO_free(kbio);
+    return err;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -65,19 +70,19 @@ int ssl_load_certs(SSL_CTX * ctx, char * cert_file, char * key_file) {
 
     // set local cert from certfile
     if (SSL_CTX_use_certificate_file(ctx, cert_file, SSL_FILETYPE_PEM) <= 0) {
-        LOG("error: failed to load certificate file\n");
+        LOG_ERROR("error: failed to load certificate file\n");
         return -1;
     }
 
     // set private key from keyfile (may be same as cert)
     if (SSL_CTX_use_PrivateKey_file(ctx, key_file, SSL_FILETYPE_PEM) <= 0) {
-        LOG("error: failed to load key file\n");
+        LOG_ERROR("error: failed to load key file\n");
         return -1; 
     }
 
     // verify private key
     if (!SSL_CTX_check_private_key(ctx)) {
-        LOG("error: private key does not match public certificate\n");
+        LOG_ERROR("error: private key does not match public certificate\n");
         return -1;
     }
 
@@ -97,17 +102,17 @@ void ssl_dump_certs(SSL * ssl) {
 
         // print cert subject
         line = X509_NAME_oneline(X509_get_subject_name(cert), 0, 0);
-        LOG("[subject]\n%s\n", line);
+        LOG_DEBUG("[subject]\n%s\n", line);
         free(line);
 
         // print cert issuer
         line = X509_NAME_oneline(X509_get_issuer_name(cert), 0, 0);
-        LOG("[issuer]\n%s\n", line);
+        LOG_DEBUG("[issuer]\n%s\n", line);
         free(line);
         X509_free(cert);
 
     } else {
-        LOG("info: no certs to dump\n");
+        LOG_INFO("info: no certs to dump\n");
     }
 }
 
@@ -117,6 +122,15 @@ void ssl_dump_certs(SSL * ssl) {
 ssl_transport::ssl_transport() {
     m_ctx = NULL;
     m_ssl = NULL;
+    m_rx_head = 0;
+    m_rx_tail = 0;
+    m_rx_want_write = false;
+    m_tx_head = 0;
+    m_tx_retry = 0;
+    m_tx_since = 0;
+    m_tx_want_write = false;
+    m_tx_blocked = false;
+    m_tx_failed = false;
     m_opt_host = sock_get_ip();
     m_opt_port = 443;
 }
@@ -138,36 +152,57 @@ int ssl_transport::init(int type) {
 
     // determine SSL method based on transport type
     if (type == TPT_CLIENT) {
-        method = (SSL_METHOD*)TLSv1_client_method();
+        method = (SSL_METHOD*)TLS_client_method();
     } else if (type == TPT_SERVER) {
-        method = (SSL_METHOD*)TLSv1_server_method();
+        method = (SSL_METHOD*)TLS_server_method();
     } else {
-        LOG("error: invalid transport type\n");
+        LOG_ERROR("error: invalid transport type\n");
         return -1;
     }
 
     // create SSL context
     m_ctx = SSL_CTX_new(method);
     if (m_ctx == NULL) {
-        LOG("error: ssl failed to created new CTX\n");
+        LOG_ERROR("error: ssl failed to created new CTX\n");
         return -1;
     }
 
+    // tls 1.2 or newer with forward secret aead ciphers only
+    SSL_CTX_set_min_proto_version(m_ctx, TLS1_2_VERSION);
+    if (!SSL_CTX_set_cipher_list(m_ctx, SSL_CIPHER_LIST)) {
+        LOG_ERROR("error: ssl has none of the configured ciphers\n");
+        return -1;
+    }
+#ifdef TLS1_3_VERSION
+    SSL_CTX_set_ciphersuites(m_ctx, SSL_CIPHER_SUITES);
+#endif
+
+    // each process makes a single connection, so there is never a session
+    // to resume and the server doesn't cache them or issue tickets
+    SSL_CTX_set_session_cache_mode(m_ctx, SSL_SESS_CACHE_OFF);
+    SSL_CTX_set_options(m_ctx, SSL_OP_NO_TICKET);
+#ifdef TLS1_3_VERSION
+    SSL_CTX_set_num_tickets(m_ctx, 0);
+#endif
+
     // load SSL certificates from memory and verifies them 
     // NOTE: these buffers are generated by bin2cc.py 
     if (ssl_load_cert_bufs(m_ctx, _crtbuf, _crtbuf_len,
                                   _keybuf, _keybuf_len) < 0) {
-        LOG("error: ssl failed to verify certificates\n");
+        LOG_ERROR("error: ssl failed to verify certificates\n");
         return -1;
     }
-    LOG("info: SSL certificates verified\n");
+    LOG_INFO("info: SSL certificates verified\n");
         
-    // create ssl session
+    // create ssl session, writes may complete partially and be retried
+    // from a queue that has been reallocated in between
     m_ssl = SSL_new(m_ctx);
     if (m_ssl == NULL) {
-        LOG("error: ssl failed to create session\n");
+        LOG_ERROR("error: ssl failed to create session\n");
         return -1;
     }
+    SSL_set_mode(m_ssl, SSL_MODE_ENABLE_PARTIAL_WRITE | 
+                        SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
 
     // initialise connection based on whether we are the client or server
     int sock;
@@ -180,39 +215,40 @@ int ssl_transport::init(int type) {
 
         // pass socket to openssl
         SSL_set_fd(m_ssl, sock);
-        if (SSL_connect(m_ssl) < 0) {
-            LOG("error: ssl connect failed\n");
+        if (SSL_connect(m_ssl) <= 0) {
+            LOG_ERROR("error: ssl connect failed\n");
             return -1;
         }
 
     } else if (type == TPT_SERVER) {
 
         // if server, bind to desired port and listen for connections
-        LOG("info: c2 server at %s:%d\n", m_opt_host.c_str(), m_opt_port);
+        LOG_INFO("info: c2 server at %s:%d\n", m_opt_host.c_str(), m_opt_port);
         if (m_tcp.bind(m_opt_port) < 0) {
             return -1;
         }
 
         // accept incoming connection
-        LOG("info: waiting for client...\n");
+        LOG_INFO("info: waiting for client...\n");
         if ((sock = m_tcp.accept()) < 0) {
             return -1;
         }
 
         // pass client socket to openssl and accept the connection 
         SSL_set_fd(m_ssl, sock);
-        if (SSL_accept(m_ssl) < 0) {
-            LOG("error: ssl accept failed\n");
+        if (SSL_accept(m_ssl) <= 0) {
+            LOG_ERROR("error: ssl accept failed\n");
             return -1;
         }
 
     } else {
-        LOG("error: invalid transport type\n");
+        LOG_ERROR("error: invalid transport type\n");
         return -1;
     }
         
     // log ssl connection info / make socket non-blocking
-    LOG("info: SSL connected using cipher (%s)\n", SSL_get_cipher(m_ssl)); 
+    LOG_INFO("info: %s connected using cipher (%s)\n", 
+             SSL_get_version(m_ssl), SSL_get_cipher(m_ssl));
     sock_set_blocking(sock, false);
     ssl_dump_certs(m_ssl);
 
@@ -223,45 +259,230 @@ int ssl_transport::init(int type) {
 ////////////////////////////////////////////////////////////////////////////////
 // SSL implementation to send transport msg's 
 
-int ssl_transport::send(message & msg) {
+// the frame is appended to the outbound queue, which is written once it 
+// fills a tls record or its oldest frame has waited SSL_SEND_DELAY_US, so 
+// bursts of small frames share records. urgent frames (e.g. keystrokes) 
+// write the queue straight away. whatever the socket won't take is 
+// written by later calls to flush(), a slow link never blocks the caller
 
-    // TODO: handle SSL_ERROR_WANT_READ
-    //       handle SSL_ERROR_WANT_WRITE using SSL_get_error()
-    // http://funcptr.net/2012/04/08/openssl-as-a-filter-%28or-non-blocking-openssl%29/
+int ssl_transport::send(message & msg, bool urgent) {
+    if (m_ssl == NULL || m_tx_failed) {
+        return TPT_ERROR;
+    }
 
-    int len = msg.data_len();
-    int bytes_sent = 0;
+    // refuse to buffer without limit if the peer has stopped reading. 
+    // callers back off at SSL_SEND_HIGHWATER, so getting here means the 
+    // stream can't be kept intact and the transport is failed, a frame is 
+    // never dropped from the middle of it
+    if (m_tx.size() - m_tx_head + msg.data_len() > SSL_SEND_MAXQUEUE) {
+        LOG_ERROR("error: SSL transport send queue full!\n");
+        m_tx_failed = true;
+        return TPT_ERROR;
+    }
 
-    // send all data 
-    while (bytes_sent < len) {
-        int bytes = SSL_write(m_ssl, msg.data() + bytes_sent, len - bytes_sent);
-        if (bytes == -1) {
-            LOG("error: SSL transport failed to send message!\n");
-            return -1;
-        } else {
-            bytes_sent += bytes;
+    if (m_tx_head == m_tx.size()) {
+        m_tx_since = time_now_us();
+    }
+    m_tx.insert(m_tx.end(), msg.data(), msg.data() + msg.data_len());
+    if (urgent || m_tx.size() - m_tx_head >= SSL_SEND_CHUNK) {
+        if (write_tx(!urgent) < 0) {
+            return TPT_ERROR;
+        }
+    }
+    return msg.data_len();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// write out queued frames once they are due, or retry a blocked write, 
+// returns the bytes still queued or TPT_ERROR
+
+int ssl_transport::flush() {
+    if (m_ssl == NULL || m_tx_failed) {
+        return TPT_ERROR;
+    }
+
+    // a read blocked on writing is retried here, what it reads is buffered
+    // and shows up in pending() for the next recv()
+    if (m_rx_want_write && m_rx_tail - m_rx_head < m_rx.size()) {
+        if (fill_rx() == TPT_ERROR) {
+            return TPT_ERROR;
         }
     }
-    return bytes_sent;
+    if (m_tx_head < m_tx.size() && (m_tx_blocked || flush_timeout() == 0)) {
+        return write_tx(false);
+    }
+    return m_tx.size() - m_tx_head;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// SSL implementation to receive transport msg's
+// milliseconds until queued frames are due to be written, -1 if nothing is
+// waiting (or it's waiting on the socket rather than the clock)
+
+int ssl_transport::flush_timeout() {
+    if (m_tx_head == m_tx.size() || m_tx_blocked) {
+        return -1;
+    }
+    uint64_t waited = time_now_us() - m_tx_since;
+    if (waited >= SSL_SEND_DELAY_US) {
+        return 0;
+    }
+    return (SSL_SEND_DELAY_US - waited + 999) / 1000;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - write queued frames until the queue is empty or the socket 
+// would block, or only whole records leaving the rest to coalesce further.
+// returns the bytes still queued or TPT_ERROR
+// see: http://funcptr.net/2012/04/08/openssl-as-a-filter-%28or-non-blocking-openssl%29/
+
+int ssl_transport::write_tx(bool whole_records) {
+    if (m_ssl == NULL || m_tx_failed) {
+        return TPT_ERROR;
+    }
+
+    m_tx_want_write = false;
+    m_tx_blocked = false;
+    while (m_tx_head < m_tx.size()) {
+
+        // a write that would have blocked must be retried with the same 
+        // length, the queue only grows at the end so the bytes still match
+        int len = m_tx_retry;
+        if (len == 0) {
+            len = MIN(m_tx.size() - m_tx_head, (size_t)SSL_SEND_CHUNK);
+            if (whole_records && len < SSL_SEND_CHUNK) {
+                m_tx_since = time_now_us(); // the rest waits for more
+                break;
+            }
+        }
+
+        int bytes = SSL_write(m_ssl, m_tx.data() + m_tx_head, len);
+        if (bytes > 0) {
+            m_tx_head += bytes;
+            m_tx_retry = 0;
+            continue;
+        }
+
+        m_tx_retry = len;
+        int err = SSL_get_error(m_ssl, bytes);
+        if (err == SSL_ERROR_WANT_WRITE) {
+            m_tx_want_write = true;
+            m_tx_blocked = true;
+            break;
+        } else if (err == SSL_ERROR_WANT_READ) {
+            m_tx_blocked = true;
+            break; // tls needs to read first, retried when readable
+        } else if (err == SSL_ERROR_SYSCALL && errno == EINTR) {
+            continue;
+        }
+        LOG_ERROR("error: SSL transport failed to send message!\n");
+        m_tx_failed = true;
+        return TPT_ERROR;
+    }
+
+    // reclaim written space, usually the whole queue has gone
+    if (m_tx_head == m_tx.size()) {
+        m_tx.clear();
+        m_tx_head = 0;
+    } else if (m_tx_head > SSL_SEND_CHUNK && m_tx_head > m_tx.size() / 2) {
+        m_tx.erase(m_tx.begin(), m_tx.begin() + m_tx_head);
+        m_tx_head = 0;
+    }
+    return m_tx.size() - m_tx_head;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// outbound data is waiting for the socket to become writable
+
+bool ssl_transport::wants_write() {
+    return m_tx_want_write || m_rx_want_write;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// enough is queued that callers should stop producing until it drains
+
+bool ssl_transport::congested() {
+    return m_tx.size() - m_tx_head >= SSL_SEND_HIGHWATER;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SSL implementation to receive transport msg's, data is read from openssl 
+// in large chunks and frames are parsed out of the buffer, so a burst of 
+// messages costs one read and frames split across reads are reassembled.
+// returns the frame size (header + body) or a TPT_* code
 
 int ssl_transport::recv(message & msg) {
 
-    // receive the message header first to determine size
-    int bytes = SSL_read(m_ssl, msg.data(), msg.header_len); 
-    if (bytes == 0) {
-        return TPT_CLOSE;
-    } else if (bytes < 0) {
-        return TPT_EMPTY; // TODO: potential unreported errors here
-    } 
+    // only go to openssl when there isn't a whole frame buffered
+    while (!rx_frame_ready()) {
+        int rc = fill_rx();
+        if (rc <= 0) return rc;
+    }
 
-    // enforce size constraint, in case of malicious msg sizes
-    msg.resize(msg.body_len());
-    bytes = SSL_read(m_ssl, msg.body(), msg.body_len());
-    return bytes;
+    // a bad header means the stream is out of sync and nothing after it 
+    // can be trusted
+    int len = msg.load(m_rx.data() + m_rx_head, m_rx_tail - m_rx_head);
+    if (len < 0) {
+        LOG_ERROR("error: SSL transport received an invalid frame\n");
+        return TPT_ERROR;
+    }
+    m_rx_head += len;
+    return len;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - check if a complete frame is buffered (or a bad header, 
+// which recv reports as an error)
+
+bool ssl_transport::rx_frame_ready() const {
+    if (m_rx_tail == m_rx_head) return false;
+    return message::frame_len(m_rx.data() + m_rx_head, 
+                              m_rx_tail - m_rx_head) != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - read as much as openssl has into the receive buffer, 
+// returns bytes read or a TPT_* code
+
+int ssl_transport::fill_rx() {
+    if (m_ssl == NULL) return TPT_ERROR;
+    if (m_rx.empty()) {
+        m_rx.resize(SSL_RECV_BUFSIZE);
+    }
+
+    // move a partial frame to the front to make room, it always fits since
+    // the buffer is larger than the biggest frame
+    if (m_rx_head > 0) {
+        memmove(m_rx.data(), m_rx.data() + m_rx_head, m_rx_tail - m_rx_head);
+        m_rx_tail -= m_rx_head;
+        m_rx_head = 0;
+    }
+
+    m_rx_want_write = false;
+    int bytes = SSL_read(m_ssl, m_rx.data() + m_rx_tail, 
+                         m_rx.size() - m_rx_tail);
+    if (bytes > 0) {
+        m_rx_tail += bytes;
+        return bytes;
+    }
+
+    // tls may have to write during a read (e.g. answering a key update), 
+    // when the socket is full the read is retried by flush() once it drains
+    switch (SSL_get_error(m_ssl, bytes)) {
+        case SSL_ERROR_WANT_READ:
+            return TPT_EMPTY;
+        case SSL_ERROR_WANT_WRITE:
+            m_rx_want_write = true;
+            return TPT_EMPTY;
+        case SSL_ERROR_ZERO_RETURN:
+            return TPT_CLOSE;
+        case SSL_ERROR_SYSCALL:
+            if (errno == EINTR || errno == EAGAIN) return TPT_EMPTY;
+            if (ERR_peek_error() == 0) return TPT_CLOSE; // eof, no shutdown
+            break;
+    }
+    LOG_ERROR("error: SSL transport failed to receive (%s)\n",
+              ERR_error_string(ERR_get_error(), NULL));
+    return TPT_ERROR;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -274,17 +495,61 @@ void ssl_transport::setopt(int opt, std::string value) {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// socket used by the SSL connection, for polling
+
+int ssl_transport::fd() {
+    return (m_ssl != NULL) ? SSL_get_fd(m_ssl) : -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// decrypted bytes buffered inside openssl or whole frames waiting in the
+// receive buffer, these won't wake a poll
+
+int ssl_transport::pending() {
+    int bytes = (m_ssl != NULL) ? SSL_pending(m_ssl) : 0;
+    if (rx_frame_ready()) {
+        bytes += m_rx_tail - m_rx_head;
+    }
+    return bytes;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // tear down SSL connection
 
 void ssl_transport::close() {
 
+    // frames still held back to coalesce (e.g. the last of the shell output)
+    // are written first, waiting a while on a slow socket. they are only 
+    // dropped if the transport has failed or the wait runs out
+    if (m_ssl != NULL && !m_tx_failed && m_tx_head < m_tx.size()) {
+        uint64_t deadline = time_now_us() + SSL_CLOSE_TIMEOUT_MS * 1000;
+        while (write_tx(false) > 0) {
+            uint64_t now = time_now_us();
+            if (now >= deadline) {
+                LOG_ERROR("error: SSL transport dropped %d queued bytes\n",
+                          (int)(m_tx.size() - m_tx_head));
+                break;
+            }
+            struct pollfd pfd;
+            pfd.fd = fd();
+            pfd.events = m_tx_want_write ? POLLOUT : POLLIN;
+            pfd.revents = 0;
+            poll(&pfd, 1, (deadline - now + 999) / 1000);
+        }
+    }
+
     // free openssl data structures
     if (m_ssl != NULL) {
         SSL_shutdown(m_ssl);
         SSL_free(m_ssl);
         m_ssl = NULL;
     }
+    m_rx_head = m_rx_tail = 0;
+    m_rx_want_write = false;
+    m_tx.clear();
+    m_tx_head = m_tx_retry = 0;
+    m_tx_want_write = m_tx_blocked = m_tx_failed = false;
     if (m_ctx != NULL) {
         SSL_CTX_free(m_ctx);
         m_ctx = NULL;
@@ -8,6 +8,7 @@
 #include <openssl/ssl.h>
 
 #include <string>
+#include <vector>
 
 #include "core.h"
 #include "sock.h"
@@ -18,6 +19,19 @@
 #define SSL_OPT_HOST 1
 #define SSL_OPT_PORT 2
 
+// tls 1.2 suites (ECDHE with AES-GCM / ChaCha20, RSA or ECDSA certs) and
+// the tls 1.3 suites allowed
+#define SSL_CIPHER_LIST "ECDHE+AESGCM:ECDHE+CHACHA20:!aNULL"
+#define SSL_CIPHER_SUITES "TLS_AES_128_GCM_SHA256:TLS_CHACHA20_POLY1305_SHA256:" \
+                          "TLS_AES_256_GCM_SHA384"
+
+#define SSL_RECV_BUFSIZE (128 << 10)    // must hold the largest frame
+#define SSL_SEND_CHUNK (16 << 10)       // bytes per SSL_write (one record)
+#define SSL_SEND_MAXQUEUE (16 << 20)    // outbound bytes queued before failing
+#define SSL_SEND_HIGHWATER (1 << 20)    // queued bytes that pause new input
+#define SSL_SEND_DELAY_US 2000          // max time a frame waits to coalesce
+#define SSL_CLOSE_TIMEOUT_MS 2000       // time allowed to send the queue on close
+
 ////////////////////////////////////////////////////////////////////////////////
 // OpenSSL implementation of transport interface
 
@@ -30,10 +44,16 @@ public:
 
     // transport interface
     virtual int init(int type);
-    virtual int send(message & msg);
+    virtual int send(message & msg, bool urgent = false);
     virtual int recv(message & msg);
     virtual void setopt(int opt, std::string value);
     virtual void close();
+    virtual int fd();
+    virtual int pending();
+    virtual int flush();
+    virtual int flush_timeout();
+    virtual bool wants_write();
+    virtual bool congested();
 
 protected:
 
@@ -47,6 +67,25 @@ protected:
     // openssl members
     SSL * m_ssl;
     SSL_CTX * m_ctx;
+
+    // receive buffer, frames are parsed from [m_rx_head, m_rx_tail)
+    std::vector<char> m_rx;
+    size_t m_rx_head;
+    size_t m_rx_tail;
+    bool m_rx_want_write;               // SSL_read needs the socket writable
+
+    // send queue, bytes from m_tx_head are still to be written
+    std::vector<char> m_tx;
+    size_t m_tx_head;
+    int m_tx_retry;                     // length of a write to retry
+    uint64_t m_tx_since;                // when the oldest queued frame came
+    bool m_tx_want_write;
+    bool m_tx_blocked;
+    bool m_tx_failed;
+
+    int fill_rx();
+    int write_tx(bool whole_records);
+    bool rx_frame_ready() const;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////////////////////////
+// test_message.cc
+// author: jcramb@gmail.com
+//
+// standalone message checks, grows messages from the inline buffer into
+// pooled ones and makes sure nothing already written is lost. exits
+// non-zero if any case fails
+//
+// usage: ./test_message
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+
+#include "core.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - fill / check a pattern that differs for every offset, and
+// for every case so a reused pool buffer can't pass by still holding it
+
+static int g_seed = 0;
+
+static void fill(char * buf, size_t off, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (char)((off + i) * 7 + g_seed);
+    }
+}
+
+static bool check(const char * buf, size_t off, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (buf[i] != (char)((off + i) * 7 + g_seed)) return false;
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// test cases, the body is written at one size then resized
+
+struct test_case {
+    const char * name;
+    size_t written;                     // body bytes written first
+    size_t shrunk;                      // smaller size set in between (or 0)
+    size_t resized;                     // body size set afterwards
+};
+
+static const test_case g_cases[] = {
+    { "header before size",  100, 0, 4096 },
+    { "full inline buffer",  message::inline_len, 0, message::inline_len + 1 },
+    { "pooled to pooled",    1000, 0, 40000 },
+    { "shrink then grow",    100, 10, 64 * 1024 },
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - run one case, the body is written into a zero length
+// message the way the proxy writes its header, or sized first if needed
+
+static bool run_case(const test_case & tc) {
+    message msg(MSG_PROXY_DATA);
+    if (tc.written > message::inline_len) {
+        msg.resize(tc.written);
+    }
+    fill(msg.body(), 0, tc.written);
+
+    // a shrink in between must not lose the bytes either
+    if (tc.shrunk > 0) {
+        msg.resize(tc.shrunk);
+    }
+    msg.resize(tc.resized);
+    if (msg.type() != MSG_PROXY_DATA || msg.body_len() != tc.resized) {
+        return false;
+    }
+    if (!check(msg.body(), 0, tc.written)) {
+        return false;
+    }
+
+    // copies keep the body too
+    fill(msg.body() + tc.written, tc.written, tc.resized - tc.written);
+    message copy(msg);
+    return copy.body_len() == tc.resized &&
+           check(copy.body(), 0, tc.resized);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// entry point
+
+int main(int argc, char **argv) {
+    int failed = 0;
+    int count = sizeof(g_cases) / sizeof(g_cases[0]);
+    for (int i = 0; i < count; i++) {
+        g_seed = i + 1;
+        if (!run_case(g_cases[i])) {
+            printf("FAIL: %s (%d -> %d bytes)\n", g_cases[i].name,
+                   (int)g_cases[i].written, (int)g_cases[i].resized);
+            failed++;
+        }
+    }
+    printf("%d cases, %d failed\n", count, failed);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+// test_record.cc
+// author: jcramb@gmail.com
+//
+// standalone recorder checks, writes output through the session recorder
+// and reads it back with the player. exits non-zero if any case fails
+//
+// usage: ./test_record
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <string>
+
+#include "record.h"
+
+#define FFFD "\xef\xbf\xbd"
+
+////////////////////////////////////////////////////////////////////////////////
+// test cases, each input is recorded in one write and must play back as the
+// expected bytes
+
+struct test_case {
+    const char * name;
+    const char * input;
+    const char * expect;
+};
+
+static const test_case g_cases[] = {
+    { "valid 2/3/4 byte", "a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80z",
+                          "a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80z" },
+    { "overlong 3 byte",  "a\xe0\x80\xafz", "a" FFFD FFFD FFFD "z" },
+    { "surrogate",        "a\xed\xa0\x80z", "a" FFFD FFFD FFFD "z" },
+    { "above U+10FFFF",   "a\xf4\x90\x80\x80z", "a" FFFD FFFD FFFD FFFD "z" },
+    { "bad continuation", "a\xc3(z", "a" FFFD "(z" },
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - record input (optionally split in two writes) and play it back
+
+static bool run_case(const test_case & tc, int split, std::string & got) {
+    char path[] = "/tmp/test_record.XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("mkstemp");
+        return false;
+    }
+    close(fd);
+
+    int len = strlen(tc.input);
+    if (split > len) split = len;
+    session_recorder rec;
+    if (rec.open(path, 24, 80) != 0) {
+        perror("open");
+        unlink(path);
+        return false;
+    }
+    rec.output(tc.input, split);
+    rec.output(tc.input + split, len - split);
+    rec.close();
+
+    session_player player;
+    got.clear();
+    if (player.open(path) == 0) {
+        double time;
+        char code;
+        std::string data;
+        while (player.next(time, code, data)) {
+            if (code == REC_OUTPUT) got += data;
+        }
+    }
+    unlink(path);
+    return got == tc.expect;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// entry point
+
+int main(int argc, char **argv) {
+    int failed = 0;
+    int count = sizeof(g_cases) / sizeof(g_cases[0]);
+
+    // every case is also split at each byte, so sequences cut across reads
+    // are covered by the same expectations
+    for (int i = 0; i < count; i++) {
+        int len = strlen(g_cases[i].input);
+        for (int split = 0; split <= len; split++) {
+            std::string got;
+            if (!run_case(g_cases[i], split, got)) {
+                printf("FAIL: %s (split at %d), got \"",
+                       g_cases[i].name, split);
+                for (size_t j = 0; j < got.size(); j++) {
+                    printf("\\x%02x", (unsigned char)got[j]);
+                }
+                printf("\"\n");
+                failed++;
+            }
+        }
+    }
+    printf("%d cases, %d failed\n", count, failed);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,252 @@
+////////////////////////////////////////////////////////////////////////////////
+// trace.cc
+// author: jcramb@gmail.com
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "trace.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - padded size of a record body
+
+static size_t trace_padded(size_t len) {
+    return (len + TRACE_ALIGN - 1) & ~(size_t)(TRACE_ALIGN - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - read a clock in microseconds
+
+static uint64_t trace_clock_us(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - write a whole buffer, retrying short writes
+
+static int trace_write_all(int fd, const char * buf, size_t len) {
+    while (len > 0) {
+        ssize_t bytes = write(fd, buf, len);
+        if (bytes < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        buf += bytes;
+        len -= bytes;
+    }
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// trace writer ctors / dtors
+
+trace_writer::trace_writer() {
+    m_fd = -1;
+    m_buf = NULL;
+    m_len = 0;
+    m_start_us = 0;
+}
+
+trace_writer::~trace_writer() {
+    close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// create trace file and write the file header
+
+int trace_writer::open(const char * path) {
+    close();
+
+    m_fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        return -1;
+    }
+
+    m_buf = (char*)malloc(TRACE_BUFSIZE);
+    m_len = 0;
+    m_start_us = trace_clock_us(CLOCK_MONOTONIC);
+
+    trace_file_header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, TRACE_MAGIC, sizeof(hdr.magic));
+    hdr.version = TRACE_VERSION;
+    hdr.header_len = sizeof(hdr);
+    hdr.start_time = trace_clock_us(CLOCK_REALTIME);
+    memcpy(m_buf, &hdr, sizeof(hdr));
+    m_len = sizeof(hdr);
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// write buffered records to the trace file
+
+void trace_writer::flush() {
+    if (m_fd < 0 || m_len == 0) return;
+    if (trace_write_all(m_fd, m_buf, m_len) < 0) {
+        close();
+        return;
+    }
+    m_len = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// flush and close the trace file
+
+void trace_writer::close() {
+    if (m_fd >= 0) {
+        trace_write_all(m_fd, m_buf, m_len);
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    free(m_buf);
+    m_buf = NULL;
+    m_len = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// append a message to the trace
+
+void trace_writer::record(int dir, int type, const char * body, size_t len) {
+    if (m_fd < 0) return;
+
+    trace_record rec;
+    rec.time_us = trace_clock_us(CLOCK_MONOTONIC) - m_start_us;
+    rec.len = len;
+    rec.type = type;
+    rec.dir = dir;
+    rec.reserved = 0;
+
+    size_t size = sizeof(rec) + trace_padded(len);
+    if (m_len + size > TRACE_BUFSIZE) {
+        flush();
+        if (m_fd < 0) return;
+    }
+
+    // bodies too big to batch go straight to the file
+    if (size > TRACE_BUFSIZE) {
+        static const char pad[TRACE_ALIGN] = {0};
+        struct iovec iov[3];
+        iov[0].iov_base = &rec;
+        iov[0].iov_len = sizeof(rec);
+        iov[1].iov_base = (void*)body;
+        iov[1].iov_len = len;
+        iov[2].iov_base = (void*)pad;
+        iov[2].iov_len = trace_padded(len) - len;
+        if (writev(m_fd, iov, 3) != (ssize_t)size) {
+            close();
+        }
+        return;
+    }
+
+    char * p = m_buf + m_len;
+    memcpy(p, &rec, sizeof(rec));
+    memcpy(p + sizeof(rec), body, len);
+    memset(p + sizeof(rec) + len, 0, trace_padded(len) - len);
+    m_len += size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// trace reader ctors / dtors
+
+trace_reader::trace_reader() {
+    m_map = NULL;
+    m_size = 0;
+    m_pos = 0;
+}
+
+trace_reader::~trace_reader() {
+    close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// map a trace file and check its header
+
+int trace_reader::open(const char * path) {
+    close();
+
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(trace_file_header)) {
+        ::close(fd);
+        return -1;
+    }
+
+    void * map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+    m_map = (char*)map;
+    m_size = st.st_size;
+
+    const trace_file_header * hdr = header();
+    if (memcmp(hdr->magic, TRACE_MAGIC, sizeof(hdr->magic)) != 0 ||
+        hdr->version != TRACE_VERSION ||
+        hdr->header_len < sizeof(*hdr) || hdr->header_len > m_size) {
+        close();
+        return -1;
+    }
+
+    rewind();
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// unmap the trace file
+
+void trace_reader::close() {
+    if (m_map != NULL) {
+        munmap(m_map, m_size);
+    }
+    m_map = NULL;
+    m_size = 0;
+    m_pos = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// get the file header
+
+const trace_file_header * trace_reader::header() const {
+    return (const trace_file_header*)m_map;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// get the next record, a record cut short (e.g. a crashed writer) ends it
+
+bool trace_reader::next(const trace_record ** rec, const char ** body) {
+    if (m_map == NULL || m_size - m_pos < sizeof(trace_record)) {
+        return false;
+    }
+
+    const trace_record * r = (const trace_record*)(m_map + m_pos);
+    size_t size = sizeof(*r) + trace_padded(r->len);
+    if (size > m_size - m_pos) {
+        return false;
+    }
+
+    *rec = r;
+    *body = m_map + m_pos + sizeof(*r);
+    m_pos += size;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// go back to the first record
+
+void trace_reader::rewind() {
+    m_pos = (m_map != NULL) ? header()->header_len : 0;
+}
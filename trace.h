@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+// trace.h
+// author: jcramb@gmail.com
+
+#ifndef trace_h
+#define trace_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// defines
+
+#define TRACE_MAGIC "RVTRACE1"
+#define TRACE_VERSION 1
+#define TRACE_BUFSIZE (64 << 10)        // records batched before a write
+#define TRACE_ALIGN 8                   // records start on 8 byte boundaries
+
+#define TRACE_RX 0                      // message received from the peer
+#define TRACE_TX 1                      // message sent to the peer
+
+////////////////////////////////////////////////////////////////////////////////
+// on disk format
+//
+// a file header followed by records, each a fixed size header and the raw
+// message body padded to TRACE_ALIGN, so a mapped file can be walked in
+// place without copying or parsing. fields are host byte order
+
+struct trace_file_header {
+    char magic[8];                      // TRACE_MAGIC
+    uint32_t version;                   // TRACE_VERSION
+    uint32_t header_len;                // sizeof(trace_file_header)
+    uint64_t start_time;                // wall clock at open (unix us)
+};
+
+struct trace_record {
+    uint64_t time_us;                   // monotonic us since trace opened
+    uint32_t len;                       // body length (excluding padding)
+    uint16_t type;                      // MSG_* type
+    uint8_t dir;                        // TRACE_RX / TRACE_TX
+    uint8_t reserved;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// append only trace writer, each record costs one copy into a buffer that
+// is written out when full or flushed
+
+class trace_writer {
+public:
+
+    // ctors / dtors
+    trace_writer();
+    ~trace_writer();
+
+    // file handling
+    int open(const char * path);
+    void flush();
+    void close();
+    bool is_open() const { return m_fd >= 0; }
+
+    // append a message to the trace
+    void record(int dir, int type, const char * body, size_t len);
+
+protected:
+    int m_fd;
+    char * m_buf;
+    size_t m_len;
+    uint64_t m_start_us;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// trace reader, maps the whole file and walks the records in place
+
+class trace_reader {
+public:
+
+    // ctors / dtors
+    trace_reader();
+    ~trace_reader();
+
+    // file handling
+    int open(const char * path);
+    void close();
+    const trace_file_header * header() const;
+
+    // get the next record and its body, returns false at end of trace
+    bool next(const trace_record ** rec, const char ** body);
+    void rewind();
+
+protected:
+    char * m_map;
+    size_t m_size;
+    size_t m_pos;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // trace_h
@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////
+// tracedump.cc
+// author: jcramb@gmail.com
+//
+// offline decoder for message traces written by `./server -t <file>`
+//
+// usage: ./tracedump [-r] [-x] [file ...]
+//
+// prints one line per message, with -x adding a hexdump of each body. with
+// -r the received shell output is written raw to stdout instead, so a
+// session can be piped into a terminal or saved for `./bench`
+
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstdio>
+
+#include "core.h"
+#include "trace.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// helper func - message type names
+
+static const char * msg_name(int type) {
+    switch (type) {
+        case MSG_RVSHELL:    return "RVSHELL";
+        case MSG_WNDSIZE:    return "WNDSIZE";
+        case MSG_PROXY_INIT: return "PROXY_INIT";
+        case MSG_PROXY_PASS: return "PROXY_PASS";
+        case MSG_PROXY_FAIL: return "PROXY_FAIL";
+        case MSG_PROXY_DATA: return "PROXY_DATA";
+        case MSG_PROXY_DEAD: return "PROXY_DEAD";
+    }
+    return "INVALID";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// decode one trace file
+
+static int dump_trace(const char * path, bool raw, bool hex) {
+    trace_reader trace;
+    if (trace.open(path) < 0) {
+        fprintf(stderr, "%s: not a readable trace file\n", path);
+        return -1;
+    }
+
+    const trace_record * rec;
+    const char * body;
+    int count[2] = {0, 0};
+    while (trace.next(&rec, &body)) {
+        int dir = (rec->dir == TRACE_TX) ? TRACE_TX : TRACE_RX;
+
+        // raw mode only passes the shell output through
+        if (raw) {
+            if (dir == TRACE_RX && rec->type == MSG_RVSHELL) {
+                fwrite(body, 1, rec->len, stdout);
+            }
+            continue;
+        }
+
+        printf("%s: [%04d] %4llu.%06llu %-10s %u bytes\n",
+               dir == TRACE_RX ? "RD" : "WR", count[dir]++,
+               (unsigned long long)(rec->time_us / 1000000),
+               (unsigned long long)(rec->time_us % 1000000),
+               msg_name(rec->type), rec->len);
+        if (hex) {
+            hexdump(body, rec->len, 16, true, stdout);
+        }
+    }
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// decode trace files given on the command line
+
+int main(int argc, char ** argv) {
+    bool raw = false;
+    bool hex = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "rxh")) != -1) {
+        switch (opt) {
+            case 'r': raw = true; break;
+            case 'x': hex = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-r] [-x] [file ...]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "usage: %s [-r] [-x] [file ...]\n", argv[0]);
+        return 1;
+    }
+
+    int rc = 0;
+    for (int i = optind; i < argc; i++) {
+        if (dump_trace(argv[i], raw, hex) < 0) rc = 1;
+    }
+    return rc;
+}
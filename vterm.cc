@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <limits.h>
 #include <poll.h>
 #include <utmp.h>
 #include <pwd.h>
@@ -23,32 +24,96 @@
 #include <sys/stat.h>
 
 #include <glib.h>
-#include <curses.h>
+#include <curses.h>                             // KEY_* codes for input only
 
-struct vterm_cell_t {
-   chtype         ch;                           // cell data
-   guint          attr;                         // cell attributes
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+   Scrollback lines are stored compactly: trailing blanks are dropped, the
+   attributes are run-length encoded and the characters are packed into
+   bytes unless the line needs wider ones. A line is one allocation laid
+   out as the header, then nruns runs, then len characters. The double
+   width flags aren't stored, so a line of wide chars is still one run.
+*/
+
+struct vterm_sb_run_t {
+   guint32        attr;                         // attributes of the run
+   guint16        count;                        // cells in the run
+};
+
+struct vterm_sb_line_t {
+   guint16        len;                          // cells stored
+   guint16        nruns;                        // attribute runs
+   guint32        wide;                         /* chars are guint32, also
+                                                   keeps the runs aligned */
+};
+
+#define VTERM_SB_RUNS(line)                                       \
+   ((vterm_sb_run_t*)((guint8*)(line)+sizeof(vterm_sb_line_t)))
+#define VTERM_SB_CHARS(line)                                      \
+   ((guint8*)(VTERM_SB_RUNS(line)+(line)->nruns))
+
+struct vterm_dirty_t {
+   gint           start;                        // first dirty column
+   gint           end;                          // last dirty column (-1 if clean)
 };
 
 struct vterm_t {
     gint            rows,cols;                 // terminal height & width
-    WINDOW         *window;                    // curses window
-    vterm_cell_t  **cells;
+    const vterm_backend_t *backend;            // output backend
+    void           *backend_ctx;               // backend private data
+    vterm_cell_t   *cells;                     // contiguous rows*cols grid
+    gint           *row_map;                   /* physical row holding each
+                                                  logical row, so scrolling
+                                                  (a region too) moves these
+                                                  instead of the cells       */
+    vterm_cell_t   *alt_cells;                 /* the screen not showing,
+                                                  swapped with cells (NULL
+                                                  until first used)         */
+    gint           *alt_row_map;
+    gint            alt_saved_x,alt_saved_y;   // cursor saved by mode 1049
+    vterm_dirty_t  *dirty;                     // per-row dirty column spans
+    gint            dirty_min,dirty_max;       // range of rows with dirty spans
+    gint            full_min,full_max;         /* rows dirty across their whole
+                                                  width, kept as one range so
+                                                  a scroll marks it in O(1)  */
+    gint            prow,pcol;                 // cursor drawn by last update
+    vterm_sb_line_t **sb_lines;                /* scrollback ring, sb_head
+                                                  is the oldest line       */
+    guint           sb_head,sb_count;
+    guint           sb_max_lines;              // ring size, 0 is disabled
+    gsize           sb_bytes,sb_max_bytes;     // memory held by the lines
+    gint            view_offset;               // lines scrolled back
+    gboolean        view_dirty;                // view moved since update
+    vterm_cell_t   *view_row;                  // row decoded from history
     gchar           ttyname[96];               // populated with ttyname_r()
-    guint           curattr;                   // current attribute set
+    guint32         curattr;                   // current attribute set
     gint            crow,ccol;                 // current cursor column & row
     gint            scroll_min;                // top of scrolling region
     gint            scroll_max;                // bottom of scrolling region
     gint            saved_x,saved_y;           // saved cursor coords
-    short           colors;                    // color pair for default fg/bg
-    gint            fg,bg;                     // current fg/bg colors
-    gchar           esbuf[ESEQ_BUF_SIZE];      /* 0-terminated string. Does
-                                                  NOT include the initial
-                                                  escape (\x1B) character.   */
-    gint            esbuf_len;                 /* length of buffer. The
-                                                  following property is
-                                                  always kept:
-                                                  esbuf[esbuf_len] == '\0'   */
+    gint            default_fg,default_bg;     // colors for blank cells
+    gint            fg,bg;                     // current fg/bg colors (-1 default)
+    guint8          pstate;                    // escape parser state
+    gchar           esc_private;               // CSI private marker (?<=>)
+    gchar           esc_inter[ESEQ_MAX_INTER]; // collected intermediates
+    gint            esc_inter_len;
+    gint            csi_param[MAX_CSI_ES_PARAMS]; /* CSI parameters, collected
+                                                  as the bytes arrive      */
+    gint            csi_pcount;                /* number of parameters, 0 if
+                                                  none were given           */
+    gint            csi_sub[MAX_CSI_SUB_PARAMS]; /* ':' sub-parameters of the
+                                                  last parameter            */
+    gint            csi_subcount;              // may exceed the array
+    gboolean        csi_dropped;               // a parameter was ignored
+    gchar           esc_final;                 // final byte being dispatched
+    guint32         utf8_cp;                   // utf-8 char being decoded
+    guint32         utf8_min;                  // smallest valid value for it
+    gint            utf8_left;                 // continuation bytes to come
     gint            pty_fd;                    /* file descriptor for the pty
                                                   attached to this terminal. */
     pid_t           child_pid;                 // pid of the child process
@@ -57,6 +122,34 @@ struct vterm_t {
     void            (*write) (vterm_t*,guint32);
 };
 
+/* returns the cells of logical row r (0 is the top of the screen) */
+static inline vterm_cell_t* vterm_row(vterm_t *vterm,int r)
+{
+   return vterm->cells+(vterm->row_map[r]*vterm->cols);
+}
+
+/* creates a row map where every logical row is stored in order */
+static gint* vterm_new_row_map(gint *map,int height)
+{
+   int   i;
+
+   map=(gint*)g_realloc(map,sizeof(gint)*height);
+   for(i=0;i < height;i++) map[i]=i;
+
+   return map;
+}
+
+/* attributes of an erased cell */
+#define VTERM_BLANK_ATTR(vterm)                                   \
+   VTERM_ATTR_COLOR((vterm)->default_fg,(vterm)->default_bg)
+
+const vterm_backend_t vterm_null_backend=
+{
+   NULL,
+   NULL,
+   NULL
+};
+
 vterm_t* vterm_create(guint width,guint height,guint flags)
 {
    vterm_t        *vterm;
@@ -64,8 +157,6 @@ vterm_t* vterm_create(guint width,guint height,guint flags)
    char           *user_shell=NULL;
    pid_t          child_pid;
    int            master_fd;
-   //int            cell_count;
-   int            i;
 
    if(height <= 0 || width <= 0) return NULL;
 
@@ -75,15 +166,21 @@ vterm_t* vterm_create(guint width,guint height,guint flags)
    vterm->rows=height;
    vterm->cols=width;
 
-   //cell_count=width*height;
-
    /* create the cell matrix */
-   vterm->cells=(vterm_cell_t**)g_malloc0(sizeof(vterm_cell_t*)*height);
+   vterm->cells=(vterm_cell_t*)g_malloc0(sizeof(vterm_cell_t)*width*height);
+   vterm->row_map=vterm_new_row_map(NULL,height);
 
-   for(i=0;i < height;i++)
-   {
-      vterm->cells[i]=(vterm_cell_t*)g_malloc0(sizeof(vterm_cell_t)*width);
-   }
+   /* default colors and no output until a backend is attached */
+   vterm->default_fg=-1;
+   vterm->default_bg=-1;
+   vterm->backend=&vterm_null_backend;
+
+   /* row buffer used to paint lines from the scrollback */
+   vterm->view_row=(vterm_cell_t*)g_malloc0(sizeof(vterm_cell_t)*width);
+
+   /* create the dirty span list, everything starts dirty */
+   vterm->dirty=(vterm_dirty_t*)g_malloc0(sizeof(vterm_dirty_t)*height);
+   vterm_dirty_clear(vterm);
 
    // initialize all cells with defaults
    vterm_erase(vterm);
@@ -93,7 +190,7 @@ vterm_t* vterm_create(guint width,guint height,guint flags)
    vterm->ccol=0;
 
    // default active colors
-   vterm->curattr=COLOR_PAIR(vterm->colors);
+   vterm_reset_attr(vterm);
 
    // initial scrolling area is the whole window
    vterm->scroll_min=0;
@@ -108,12 +205,16 @@ vterm_t* vterm_create(guint width,guint height,guint flags)
 
 void vterm_destroy(vterm_t *vterm)
 {
-   int   i;
-
    if(vterm==NULL) return;
 
-   for(i=0;i < vterm->rows;i++) g_free(vterm->cells[i]);
+   vterm_set_scrollback(vterm,0,0);
+
    g_free(vterm->cells);
+   g_free(vterm->alt_cells);
+   g_free(vterm->row_map);
+   g_free(vterm->alt_row_map);
+   g_free(vterm->dirty);
+   g_free(vterm->view_row);
 
    g_free(vterm);
 
@@ -141,67 +242,650 @@ const gchar* vterm_get_ttyname(vterm_t *vterm)
    return (const gchar*)vterm->ttyname;
 }
 
-// WINDOW
+// OUTPUT
 
-void vterm_wnd_set(vterm_t *vterm,WINDOW *window)
+void vterm_set_backend(vterm_t *vterm,const vterm_backend_t *backend,
+   void *ctx)
 {
    if(vterm==NULL) return;
 
-   vterm->window=window;
+   if(backend==NULL) backend=&vterm_null_backend;
+
+   vterm->backend=backend;
+   vterm->backend_ctx=ctx;
+
+   /* a new backend has nothing on screen yet */
+   vterm_touch(vterm);
 
    return;
 }
 
-WINDOW* vterm_wnd_get(vterm_t *vterm)
+void* vterm_get_backend_ctx(vterm_t *vterm,const vterm_backend_t *backend)
 {
-   return vterm->window;
+   if(vterm==NULL) return NULL;
+   if(vterm->backend != backend) return NULL;
+
+   return vterm->backend_ctx;
 }
 
-void vterm_wnd_update(vterm_t *vterm)
+void vterm_update(vterm_t *vterm)
 {
-   int      i;
-   int      x,y;
-   int      cell_count;
-   chtype   ch;
-   guint    attr;
+   void           (*draw)(void*,int,int,const vterm_cell_t*,int);
+   int            y;
+   int            start;
+   int            end;
+   vterm_cell_t   *row;
+   vterm_cell_t   cursor;
 
    if(vterm==NULL) return;
-   if(vterm->window==NULL) return;
 
-   cell_count=vterm->rows*vterm->cols;
+   draw=vterm->backend->draw;
+   if(draw==NULL)
+   {
+      vterm_dirty_clear(vterm);
+      return;
+   }
+
+   if(vterm->view_offset > 0)
+   {
+      vterm_update_view(vterm);
+      if(vterm->backend->flush != NULL)
+         vterm->backend->flush(vterm->backend_ctx);
+      return;
+   }
+
+   /* the cell under the previous cursor must be restored */
+   vterm_dirty_span(vterm,vterm->prow,vterm->pcol,vterm->pcol);
 
-   for(i=0;i < cell_count;i++)
+   /* only repaint the spans touched since the last update */
+   for(y=vterm->dirty_min;y <= vterm->dirty_max;y++)
    {
-      x=i%vterm->cols;
-      y=(int)(i/vterm->cols);
+      if(y >= vterm->full_min && y <= vterm->full_max)
+      {
+         start=0;
+         end=vterm->cols-1;
+      }
+      else
+      {
+         start=vterm->dirty[y].start;
+         end=vterm->dirty[y].end;
+         if(end < start) continue;
+      }
+
+      /* the right half of a wide char is drawn from its left half */
+      row=vterm_row(vterm,y);
+      if(start > 0 && (row[start].attr & VTERM_ATTR_WIDE_CONT)) start--;
+
+      draw(vterm->backend_ctx,y,start,row+start,end-start+1);
+   }
+
+   vterm_dirty_clear(vterm);
 
-      ch=vterm->cells[y][x].ch;
-      attr=vterm->cells[y][x].attr;
+   vterm->prow=vterm->crow;
+   vterm->pcol=vterm->ccol;
 
-      wattrset(vterm->window,attr);
-      wmove(vterm->window,y,x);
-      waddch(vterm->window,ch);
+   /* cursor is the cell under it in reverse video on the default colors */
+   if(!(vterm->state & STATE_CURSOR_INVIS) && vterm->ccol < vterm->cols)
+   {
+      cursor=vterm_row(vterm,vterm->crow)[vterm->ccol];
+      cursor.attr=VTERM_ATTR_REVERSE | VTERM_BLANK_ATTR(vterm) |
+         (cursor.attr & (VTERM_ATTR_WIDE | VTERM_ATTR_WIDE_CONT));
+      draw(vterm->backend_ctx,vterm->crow,vterm->ccol,&cursor,1);
    }
 
-   if(!(vterm->state & STATE_CURSOR_INVIS))
+   if(vterm->backend->flush != NULL)
+      vterm->backend->flush(vterm->backend_ctx);
+
+   return;
+}
+
+/* paints the screen scrolled back into the history, the top view_offset
+ * rows come from scrollback and the live screen is pushed down */
+void vterm_update_view(vterm_t *vterm)
+{
+   int            y;
+   guint          idx;
+   vterm_cell_t   *row;
+
+   if(vterm->dirty_max < 0 && !vterm->view_dirty) return;
+
+   for(y=0;y < vterm->rows;y++)
    {
-      mvwchgat(vterm->window,vterm->crow,vterm->ccol,1,A_REVERSE,
-         vterm->colors,NULL);
+      if(y < vterm->view_offset)
+      {
+         idx=vterm->sb_head+vterm->sb_count-vterm->view_offset+y;
+         row=vterm->view_row;
+         vterm_sb_decode(vterm,vterm->sb_lines[idx % vterm->sb_max_lines],
+            row);
+      }
+      else
+      {
+         row=vterm_row(vterm,y-vterm->view_offset);
+      }
+
+      vterm->backend->draw(vterm->backend_ctx,y,0,row,vterm->cols);
    }
 
+   vterm_dirty_clear(vterm);
+   vterm->view_dirty=FALSE;
+
+   /* the cursor isn't drawn while looking at history */
+   vterm->prow=vterm->crow;
+   vterm->pcol=vterm->ccol;
+
+   return;
+}
+
+void vterm_touch(vterm_t *vterm)
+{
+   if(vterm==NULL) return;
+
+   vterm_dirty_rows(vterm,0,vterm->rows-1);
+
+   return;
+}
+
+const vterm_cell_t* vterm_get_cell(vterm_t *vterm,int row,int col)
+{
+   if(vterm==NULL) return NULL;
+   if(row < 0 || row >= vterm->rows) return NULL;
+   if(col < 0 || col >= vterm->cols) return NULL;
+
+   return vterm_row(vterm,row)+col;
+}
+
+void vterm_get_cursor(vterm_t *vterm,int *row,int *col)
+{
+   if(vterm==NULL) return;
+
+   if(row != NULL) *row=vterm->crow;
+   if(col != NULL) *col=vterm->ccol;
+
    return;
 }
 
-bool validate_escape_suffix(char c)
+/* TRUE if the remote application enabled bracketed paste (DEC mode 2004) */
+gboolean vterm_get_bracketed_paste(vterm_t *vterm)
+{
+   if(vterm==NULL) return FALSE;
+
+   return (vterm->state & STATE_BRACKET_PASTE) ? TRUE : FALSE;
+}
+
+void vterm_dirty_span(vterm_t *vterm,int row,int start_col,int end_col)
 {
-   if(c >= 'a' && c <= 'z') return TRUE;
-   if(c >= 'A' && c <= 'Z') return TRUE;
-   if(c == '@') return TRUE;
-   if(c == '`') return TRUE;
+   vterm_dirty_t  *span;
+
+   if(row < 0 || row >= vterm->rows) return;
 
-   return FALSE;
+   if(start_col < 0) start_col=0;
+   if(end_col >= vterm->cols) end_col=vterm->cols-1;
+   if(end_col < start_col) return;
+
+   span=&vterm->dirty[row];
+
+   if(span->end < span->start)
+   {
+      span->start=start_col;
+      span->end=end_col;
+   }
+   else
+   {
+      if(start_col < span->start) span->start=start_col;
+      if(end_col > span->end) span->end=end_col;
+   }
+
+   if(row < vterm->dirty_min) vterm->dirty_min=row;
+   if(row > vterm->dirty_max) vterm->dirty_max=row;
+
+   return;
 }
 
+/* whole rows are kept as a single range instead of per-row spans, rows in
+ * between two ranges are painted too but scrolling stays O(1) */
+void vterm_dirty_rows(vterm_t *vterm,int start_row,int end_row)
+{
+   if(start_row < 0) start_row=0;
+   if(end_row >= vterm->rows) end_row=vterm->rows-1;
+   if(end_row < start_row) return;
+
+   if(vterm->full_max < vterm->full_min)
+   {
+      vterm->full_min=start_row;
+      vterm->full_max=end_row;
+   }
+   else
+   {
+      if(start_row < vterm->full_min) vterm->full_min=start_row;
+      if(end_row > vterm->full_max) vterm->full_max=end_row;
+   }
+
+   if(start_row < vterm->dirty_min) vterm->dirty_min=start_row;
+   if(end_row > vterm->dirty_max) vterm->dirty_max=end_row;
+
+   return;
+}
+
+void vterm_dirty_clear(vterm_t *vterm)
+{
+   int   i;
+
+   for(i=0;i < vterm->rows;i++)
+   {
+      vterm->dirty[i].start=0;
+      vterm->dirty[i].end=-1;
+   }
+
+   vterm->dirty_min=vterm->rows;
+   vterm->dirty_max=-1;
+   vterm->full_min=0;
+   vterm->full_max=-1;
+
+   return;
+}
+
+/*
+   Scrollback
+
+   Lines scrolled off the top of the screen are kept in a ring of
+   sb_max_lines entries. Appending is O(1): the line is encoded into a
+   single allocation and the oldest lines are dropped once the line or byte
+   cap is reached.
+*/
+
+void vterm_set_scrollback(vterm_t *vterm,guint max_lines,gsize max_bytes)
+{
+   guint i;
+
+   if(vterm==NULL) return;
+
+   for(i=0;i < vterm->sb_count;i++)
+   {
+      g_free(vterm->sb_lines[(vterm->sb_head+i) % vterm->sb_max_lines]);
+   }
+   g_free(vterm->sb_lines);
+
+   vterm->sb_lines=NULL;
+   vterm->sb_head=0;
+   vterm->sb_count=0;
+   vterm->sb_bytes=0;
+   vterm->sb_max_lines=max_lines;
+   vterm->sb_max_bytes=(max_bytes > 0) ? max_bytes : G_MAXSIZE;
+
+   if(max_lines > 0)
+   {
+      vterm->sb_lines=(vterm_sb_line_t**)g_malloc0(
+         sizeof(vterm_sb_line_t*)*max_lines);
+   }
+
+   if(vterm->view_offset > 0)
+   {
+      vterm->view_offset=0;
+      vterm_touch(vterm);
+   }
+
+   return;
+}
+
+/* drops the oldest line from the scrollback */
+static void vterm_sb_pop(vterm_t *vterm)
+{
+   vterm_sb_line_t   *line;
+
+   line=vterm->sb_lines[vterm->sb_head];
+   vterm->sb_bytes-=sizeof(vterm_sb_line_t)+
+      (sizeof(vterm_sb_run_t)*line->nruns)+
+      (line->len*(line->wide ? sizeof(guint32) : 1));
+
+   g_free(line);
+   vterm->sb_lines[vterm->sb_head]=NULL;
+   vterm->sb_head=(vterm->sb_head+1) % vterm->sb_max_lines;
+   vterm->sb_count--;
+
+   if(vterm->view_offset > (gint)vterm->sb_count)
+   {
+      vterm->view_offset=vterm->sb_count;
+      vterm->view_dirty=TRUE;
+   }
+
+   return;
+}
+
+void vterm_sb_push(vterm_t *vterm,const vterm_cell_t *row)
+{
+   vterm_sb_line_t   *line;
+   vterm_sb_run_t    *run;
+   guint8            *chars;
+   guint32           blank;
+   guint32           attr;
+   guint32           prev=0;
+   gsize             size;
+   int               len;
+   int               nruns;
+   int               wide;
+   int               i;
+
+   /* trailing blanks are not stored */
+   blank=VTERM_BLANK_ATTR(vterm);
+   len=vterm->cols;
+   while(len > 0 && row[len-1].ch == ' ' &&
+      (row[len-1].attr & ~VTERM_ATTR_WIDE_CONT) == blank) len--;
+
+   nruns=0;
+   wide=0;
+   for(i=0;i < len;i++)
+   {
+      attr=row[i].attr & ~(VTERM_ATTR_WIDE | VTERM_ATTR_WIDE_CONT);
+      if(i == 0 || attr != prev) nruns++;
+      if(row[i].ch > 0xff) wide=1;
+      prev=attr;
+   }
+
+   size=sizeof(vterm_sb_line_t)+(sizeof(vterm_sb_run_t)*nruns)+
+      (len*(wide ? sizeof(guint32) : 1));
+
+   if(vterm->sb_count == vterm->sb_max_lines) vterm_sb_pop(vterm);
+   while(vterm->sb_count > 0 && vterm->sb_bytes+size > vterm->sb_max_bytes)
+   {
+      vterm_sb_pop(vterm);
+   }
+
+   line=(vterm_sb_line_t*)g_malloc(size);
+   line->len=len;
+   line->nruns=nruns;
+   line->wide=wide;
+
+   run=VTERM_SB_RUNS(line)-1;
+   chars=VTERM_SB_CHARS(line);
+   for(i=0;i < len;i++)
+   {
+      attr=row[i].attr & ~(VTERM_ATTR_WIDE | VTERM_ATTR_WIDE_CONT);
+      if(i == 0 || attr != run->attr)
+      {
+         run++;
+         run->attr=attr;
+         run->count=0;
+      }
+      run->count++;
+
+      if(wide) ((guint32*)chars)[i]=row[i].ch;
+      else chars[i]=(guint8)row[i].ch;
+   }
+
+   vterm->sb_lines[(vterm->sb_head+vterm->sb_count) % vterm->sb_max_lines]=
+      line;
+   vterm->sb_count++;
+   vterm->sb_bytes+=size;
+
+   /* keep a scrolled back view on the same lines */
+   if(vterm->view_offset > 0)
+   {
+      vterm->view_offset=MIN(vterm->view_offset+1,(gint)vterm->sb_count);
+   }
+
+   return;
+}
+
+/* expands a scrollback line into a row of cells the width of the screen */
+void vterm_sb_decode(vterm_t *vterm,const vterm_sb_line_t *line,
+   vterm_cell_t *row)
+{
+   const vterm_sb_run_t *run;
+   const guint8         *chars;
+   int                  len;
+   int                  left;
+   int                  i;
+
+   run=VTERM_SB_RUNS(line);
+   chars=VTERM_SB_CHARS(line);
+   len=MIN(line->len,vterm->cols);
+   left=(line->nruns > 0) ? run->count : 0;
+
+   for(i=0;i < len;i++)
+   {
+      if(left == 0)
+      {
+         run++;
+         left=run->count;
+      }
+      left--;
+
+      row[i].attr=run->attr;
+      row[i].ch=line->wide ? ((const guint32*)chars)[i] : chars[i];
+   }
+
+   vterm_fill_cells(row+len,vterm->cols-len,VTERM_BLANK_ATTR(vterm));
+
+   /* the width flags follow from the chars, nothing below U+1100 is wide */
+   for(i=0;i < vterm->cols;i++)
+   {
+      if(row[i].ch < 0x1100 || !g_unichar_iswide(row[i].ch)) continue;
+
+      if(i+1 == vterm->cols)
+      {
+         row[i].ch=' ';
+         break;
+      }
+      row[i].attr|=VTERM_ATTR_WIDE;
+      row[i+1].attr|=VTERM_ATTR_WIDE_CONT;
+      i++;
+   }
+
+   return;
+}
+
+/* moves the view lines back into the scrollback (negative goes forward),
+ * returns the new number of lines scrolled back */
+gint vterm_scroll_view(vterm_t *vterm,gint lines)
+{
+   gint offset;
+
+   if(vterm==NULL) return 0;
+
+   offset=CLAMP(vterm->view_offset+lines,0,(gint)vterm->sb_count);
+   if(offset == vterm->view_offset) return offset;
+
+   vterm->view_offset=offset;
+   vterm->view_dirty=TRUE;
+
+   /* back on the live screen, everything must be repainted */
+   if(offset == 0) vterm_touch(vterm);
+
+   return offset;
+}
+
+void vterm_scroll_view_reset(vterm_t *vterm)
+{
+   if(vterm==NULL) return;
+
+   vterm_scroll_view(vterm,-vterm->view_offset);
+
+   return;
+}
+
+gint vterm_get_view_offset(vterm_t *vterm)
+{
+   if(vterm==NULL) return 0;
+
+   return vterm->view_offset;
+}
+
+/*
+   Escape sequence parser
+
+   A table driven state machine modelled on Paul Williams' DEC compatible
+   parser (http://vt100.net/emu/dec_ansi_parser). Every byte is classified,
+   then the (state,class) pair gives the action to run and the next state.
+   CSI parameters are accumulated as they arrive, so a sequence is never
+   rescanned, and OSC/DCS strings are skipped without being buffered.
+*/
+
+enum
+{
+   PS_GROUND=0,
+   PS_ESCAPE,
+   PS_ESC_INTER,
+   PS_CSI_ENTRY,
+   PS_CSI_PARAM,
+   PS_CSI_INTER,
+   PS_CSI_IGNORE,
+   PS_OSC_STRING,
+   PS_STR_IGNORE,                               // DCS, SOS, PM and APC
+   PS_COUNT
+};
+
+enum
+{
+   PA_NONE=0,
+   PA_PRINT,
+   PA_EXEC,
+   PA_CLEAR,
+   PA_COLLECT,
+   PA_PARAM,
+   PA_ESC_DISPATCH,
+   PA_CSI_DISPATCH
+};
+
+enum
+{
+   CC_C0=0,                                     // other C0 controls
+   CC_BEL,                                      // 0x07
+   CC_CAN,                                      // 0x18, 0x1a
+   CC_ESC,                                      // 0x1b
+   CC_INTER,                                    // 0x20-0x2f
+   CC_DIGIT,                                    // 0x30-0x39
+   CC_SEP,                                      // ':' ';'
+   CC_PRIV,                                     // 0x3c-0x3f
+   CC_CSI,                                      // '['
+   CC_OSC,                                      // ']'
+   CC_STR,                                      // 'P' 'X' '^' '_'
+   CC_FINAL,                                    // other 0x40-0x7e
+   CC_DEL,                                      // 0x7f
+   CC_HIGH,                                     // 0x80-0xff
+   CC_COUNT
+};
+
+static const guint8 vterm_byte_class[128]=
+{
+   CC_C0,   CC_C0,   CC_C0,   CC_C0,   CC_C0,   CC_C0,   CC_C0,   CC_BEL,
+   CC_C0,   CC_C0,   CC_C0,   CC_C0,   CC_C0,   CC_C0,   CC_C0,   CC_C0,
+   CC_C0,   CC_C0,   CC_C0,   CC_C0,   CC_C0,   CC_C0,   CC_C0,   CC_C0,
+   CC_CAN,  CC_C0,   CC_CAN,  CC_ESC,  CC_C0,   CC_C0,   CC_C0,   CC_C0,
+   CC_INTER,CC_INTER,CC_INTER,CC_INTER,CC_INTER,CC_INTER,CC_INTER,CC_INTER,
+   CC_INTER,CC_INTER,CC_INTER,CC_INTER,CC_INTER,CC_INTER,CC_INTER,CC_INTER,
+   CC_DIGIT,CC_DIGIT,CC_DIGIT,CC_DIGIT,CC_DIGIT,CC_DIGIT,CC_DIGIT,CC_DIGIT,
+   CC_DIGIT,CC_DIGIT,CC_SEP,  CC_SEP,  CC_PRIV, CC_PRIV, CC_PRIV, CC_PRIV,
+   CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,
+   CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,
+   CC_STR,  CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,
+   CC_STR,  CC_FINAL,CC_FINAL,CC_CSI,  CC_FINAL,CC_OSC,  CC_STR,  CC_STR,
+   CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,
+   CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,
+   CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,
+   CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_FINAL,CC_DEL,
+};
+
+/* action in the high nibble, next state in the low nibble */
+#define PT(a,s)   ((PA_##a << 4) | PS_##s)
+
+static const guint8 vterm_parse_table[PS_COUNT][CC_COUNT]=
+{
+   /*       C0               BEL              CAN              ESC              INTER
+            DIGIT            SEP              PRIV             CSI              OSC
+            STR              FINAL            DEL              HIGH                   */
+
+   /* PS_GROUND */
+   { PT(EXEC,GROUND),   PT(EXEC,GROUND),   PT(EXEC,GROUND),   PT(CLEAR,ESCAPE),  PT(PRINT,GROUND),
+     PT(PRINT,GROUND),  PT(PRINT,GROUND),  PT(PRINT,GROUND),  PT(PRINT,GROUND),  PT(PRINT,GROUND),
+     PT(PRINT,GROUND),  PT(PRINT,GROUND),  PT(NONE,GROUND),   PT(PRINT,GROUND) },
+
+   /* PS_ESCAPE */
+   { PT(EXEC,ESCAPE),   PT(EXEC,ESCAPE),   PT(EXEC,GROUND),   PT(CLEAR,ESCAPE),  PT(COLLECT,ESC_INTER),
+     PT(ESC_DISPATCH,GROUND), PT(ESC_DISPATCH,GROUND), PT(ESC_DISPATCH,GROUND),
+     PT(CLEAR,CSI_ENTRY), PT(NONE,OSC_STRING),
+     PT(NONE,STR_IGNORE), PT(ESC_DISPATCH,GROUND), PT(NONE,ESCAPE), PT(NONE,GROUND) },
+
+   /* PS_ESC_INTER */
+   { PT(EXEC,ESC_INTER), PT(EXEC,ESC_INTER), PT(EXEC,GROUND), PT(CLEAR,ESCAPE), PT(COLLECT,ESC_INTER),
+     PT(ESC_DISPATCH,GROUND), PT(ESC_DISPATCH,GROUND), PT(ESC_DISPATCH,GROUND),
+     PT(ESC_DISPATCH,GROUND), PT(ESC_DISPATCH,GROUND),
+     PT(ESC_DISPATCH,GROUND), PT(ESC_DISPATCH,GROUND), PT(NONE,ESC_INTER), PT(NONE,GROUND) },
+
+   /* PS_CSI_ENTRY */
+   { PT(EXEC,CSI_ENTRY), PT(EXEC,CSI_ENTRY), PT(EXEC,GROUND), PT(CLEAR,ESCAPE), PT(COLLECT,CSI_INTER),
+     PT(PARAM,CSI_PARAM), PT(PARAM,CSI_PARAM), PT(COLLECT,CSI_PARAM),
+     PT(CSI_DISPATCH,GROUND), PT(CSI_DISPATCH,GROUND),
+     PT(CSI_DISPATCH,GROUND), PT(CSI_DISPATCH,GROUND), PT(NONE,CSI_ENTRY), PT(NONE,GROUND) },
+
+   /* PS_CSI_PARAM */
+   { PT(EXEC,CSI_PARAM), PT(EXEC,CSI_PARAM), PT(EXEC,GROUND), PT(CLEAR,ESCAPE), PT(COLLECT,CSI_INTER),
+     PT(PARAM,CSI_PARAM), PT(PARAM,CSI_PARAM), PT(NONE,CSI_IGNORE),
+     PT(CSI_DISPATCH,GROUND), PT(CSI_DISPATCH,GROUND),
+     PT(CSI_DISPATCH,GROUND), PT(CSI_DISPATCH,GROUND), PT(NONE,CSI_PARAM), PT(NONE,GROUND) },
+
+   /* PS_CSI_INTER */
+   { PT(EXEC,CSI_INTER), PT(EXEC,CSI_INTER), PT(EXEC,GROUND), PT(CLEAR,ESCAPE), PT(COLLECT,CSI_INTER),
+     PT(NONE,CSI_IGNORE), PT(NONE,CSI_IGNORE), PT(NONE,CSI_IGNORE),
+     PT(CSI_DISPATCH,GROUND), PT(CSI_DISPATCH,GROUND),
+     PT(CSI_DISPATCH,GROUND), PT(CSI_DISPATCH,GROUND), PT(NONE,CSI_INTER), PT(NONE,GROUND) },
+
+   /* PS_CSI_IGNORE */
+   { PT(EXEC,CSI_IGNORE), PT(EXEC,CSI_IGNORE), PT(EXEC,GROUND), PT(CLEAR,ESCAPE), PT(NONE,CSI_IGNORE),
+     PT(NONE,CSI_IGNORE), PT(NONE,CSI_IGNORE), PT(NONE,CSI_IGNORE),
+     PT(NONE,GROUND),     PT(NONE,GROUND),
+     PT(NONE,GROUND),     PT(NONE,GROUND),     PT(NONE,CSI_IGNORE), PT(NONE,GROUND) },
+
+   /* PS_OSC_STRING: ends with BEL, or ST (ESC \) via the escape state */
+   { PT(NONE,OSC_STRING), PT(NONE,GROUND), PT(EXEC,GROUND), PT(CLEAR,ESCAPE), PT(NONE,OSC_STRING),
+     PT(NONE,OSC_STRING), PT(NONE,OSC_STRING), PT(NONE,OSC_STRING),
+     PT(NONE,OSC_STRING), PT(NONE,OSC_STRING),
+     PT(NONE,OSC_STRING), PT(NONE,OSC_STRING), PT(NONE,OSC_STRING), PT(NONE,OSC_STRING) },
+
+   /* PS_STR_IGNORE: ends with ST (ESC \) via the escape state */
+   { PT(NONE,STR_IGNORE), PT(NONE,STR_IGNORE), PT(EXEC,GROUND), PT(CLEAR,ESCAPE), PT(NONE,STR_IGNORE),
+     PT(NONE,STR_IGNORE), PT(NONE,STR_IGNORE), PT(NONE,STR_IGNORE),
+     PT(NONE,STR_IGNORE), PT(NONE,STR_IGNORE),
+     PT(NONE,STR_IGNORE), PT(NONE,STR_IGNORE), PT(NONE,STR_IGNORE), PT(NONE,STR_IGNORE) },
+};
+
+#undef PT
+
+typedef void (*vterm_csi_fn)(vterm_t*,int[],int);
+
+static void interpret_csi_CUx_final(vterm_t *vterm,int param[],int pcount)
+{
+   interpret_csi_CUx(vterm,vterm->esc_final,param,pcount);
+}
+
+/* CSI handlers indexed by final byte - 0x40 */
+static const vterm_csi_fn vterm_csi_table[0x3f]=
+{
+   /* @ A B C D E F G */
+   interpret_csi_ICH,   interpret_csi_CUx_final, interpret_csi_CUx_final,
+   interpret_csi_CUx_final, interpret_csi_CUx_final, interpret_csi_CUx_final,
+   interpret_csi_CUx_final, interpret_csi_CUx_final,
+   /* H I J K L M N O */
+   interpret_csi_CUP,   NULL,                interpret_csi_ED,    interpret_csi_EL,
+   interpret_csi_IL,    interpret_csi_DL,    NULL,                NULL,
+   /* P Q R S T U V W */
+   interpret_csi_DCH,   NULL,                NULL,                NULL,
+   NULL,                NULL,                NULL,                NULL,
+   /* X Y Z [ \ ] ^ _ */
+   interpret_csi_ECH,   NULL,                NULL,                NULL,
+   NULL,                NULL,                NULL,                NULL,
+   /* ` a b c d e f g */
+   interpret_csi_CUx_final, interpret_csi_CUx_final, NULL,       NULL,
+   interpret_csi_CUx_final, interpret_csi_CUx_final, interpret_csi_CUP, NULL,
+   /* h i j k l m n o */
+   interpret_dec_SM,    NULL,                NULL,                NULL,
+   interpret_dec_RM,    interpret_csi_SGR,   NULL,                NULL,
+   /* p q r s t u v w */
+   NULL,                NULL,                interpret_csi_DECSTBM, interpret_csi_SAVECUR,
+   NULL,                interpret_csi_RESTORECUR, NULL,           NULL,
+   /* x y z { | } ~ */
+   NULL,                NULL,                NULL,                NULL,
+   NULL,                NULL,                NULL,
+};
 
 void clamp_cursor_to_bounds(vterm_t *vterm)
 {
@@ -309,34 +993,146 @@ void vterm_remote_read(vterm_t * vterm, const char * buf, int len) {
     vterm_render(vterm, buf, len);
 }
 
-void vterm_put_char(vterm_t *vterm,chtype c)
+/* blanks the other half of a double width char being partly overwritten or
+ * erased at col of row r, so no cell is left pointing at a char that is
+ * gone */
+static void vterm_split_wide(vterm_t *vterm,int r,int col)
+{
+   vterm_cell_t   *row=vterm_row(vterm,r);
+
+   if(col < 0 || col >= vterm->cols) return;
+
+   if((row[col].attr & VTERM_ATTR_WIDE_CONT) && col > 0)
+   {
+      row[col].attr&=~VTERM_ATTR_WIDE_CONT;
+      col--;
+      row[col].ch=' ';
+      row[col].attr&=~VTERM_ATTR_WIDE;
+      vterm_dirty_span(vterm,r,col,col);
+   }
+   else if((row[col].attr & VTERM_ATTR_WIDE) && col+1 < vterm->cols)
+   {
+      col++;
+      row[col].ch=' ';
+      row[col].attr&=~VTERM_ATTR_WIDE_CONT;
+      vterm_dirty_span(vterm,r,col,col);
+   }
+}
+
+void vterm_put_char(vterm_t *vterm,guint32 c)
 {
 	static char		vt100_acs[]="`afgjklmnopqrstuvwxyz{|}~";
+   vterm_cell_t   *row;
+   vterm_cell_t   *cell;
+   gint           width=1;
 
-   if(vterm->ccol >= vterm->cols)
+   if(c >= 0x80)
    {
+      /* combining marks have no cell of their own and are dropped */
+      if(g_unichar_iszerowidth(c)) return;
+      if(g_unichar_iswide(c) && vterm->cols > 1) width=2;
+   }
+
+   if(vterm->ccol+width > vterm->cols)
+   {
+      /* a wide char that doesn't fit wraps, leaving the last column */
+      if(vterm->ccol < vterm->cols)
+      {
+         row=vterm_row(vterm,vterm->crow);
+         vterm_split_wide(vterm,vterm->crow,vterm->ccol);
+         row[vterm->ccol].ch=' ';
+         row[vterm->ccol].attr=vterm->curattr;
+         vterm_dirty_span(vterm,vterm->crow,vterm->ccol,vterm->ccol);
+      }
       vterm->ccol=0;
       vterm_scroll_down(vterm);
    }
 
-   if(IS_MODE_ACS(vterm))
+   row=vterm_row(vterm,vterm->crow);
+   cell=row+vterm->ccol;
+
+   if(cell->attr & (VTERM_ATTR_WIDE | VTERM_ATTR_WIDE_CONT))
+      vterm_split_wide(vterm,vterm->crow,vterm->ccol);
+   if(width == 2 && (cell[1].attr & VTERM_ATTR_WIDE))
+      vterm_split_wide(vterm,vterm->crow,vterm->ccol+1);
+
+   if(width == 2)
+   {
+      cell[0].ch=c;
+      cell[0].attr=vterm->curattr | VTERM_ATTR_WIDE;
+      cell[1].ch=' ';
+      cell[1].attr=vterm->curattr | VTERM_ATTR_WIDE_CONT;
+   }
+   else if(IS_MODE_ACS(vterm) && c < 0x80)
    {
 	   if(strchr(vt100_acs,(char)c)!=NULL)
       {
-         vterm->cells[vterm->crow][vterm->ccol].ch=NCURSES_ACS(c);
+         cell->ch=c;
+         cell->attr=vterm->curattr | VTERM_ATTR_ACS;
+      }
+      else
+      {
+         /* not a line drawing char, only the attributes change */
+         cell->attr=vterm->curattr | (cell->attr & VTERM_ATTR_ACS);
       }
    }
    else
    {
-      vterm->cells[vterm->crow][vterm->ccol].ch=c;
+      cell->ch=c;
+      cell->attr=vterm->curattr;
    }
 
-   vterm->cells[vterm->crow][vterm->ccol].attr=vterm->curattr;
-   vterm->ccol++;
+   vterm_dirty_span(vterm,vterm->crow,vterm->ccol,vterm->ccol+width-1);
+   vterm->ccol+=width;
 
    return;
 }
 
+/* feeds one byte of a utf-8 sequence to the decoder, printing the char once
+ * it is complete. malformed, overlong and surrogate sequences print U+FFFD */
+static void vterm_put_utf8(vterm_t *vterm,guint8 c)
+{
+   guint32  cp;
+
+   if((c & 0xc0) == 0x80)
+   {
+      if(vterm->utf8_left == 0)
+      {
+         vterm_put_char(vterm,0xfffd);
+         return;
+      }
+
+      vterm->utf8_cp=(vterm->utf8_cp << 6) | (c & 0x3f);
+      if(--vterm->utf8_left > 0) return;
+
+      cp=vterm->utf8_cp;
+      if(cp < vterm->utf8_min || (cp >= 0xd800 && cp <= 0xdfff) ||
+         cp > 0x10ffff) cp=0xfffd;
+      vterm_put_char(vterm,cp);
+      return;
+   }
+
+   if(c >= 0xc2 && c <= 0xdf)
+   {
+      vterm->utf8_cp=c & 0x1f;
+      vterm->utf8_min=0x80;
+      vterm->utf8_left=1;
+   }
+   else if(c >= 0xe0 && c <= 0xef)
+   {
+      vterm->utf8_cp=c & 0x0f;
+      vterm->utf8_min=0x800;
+      vterm->utf8_left=2;
+   }
+   else if(c >= 0xf0 && c <= 0xf4)
+   {
+      vterm->utf8_cp=c & 0x07;
+      vterm->utf8_min=0x10000;
+      vterm->utf8_left=3;
+   }
+   else vterm_put_char(vterm,0xfffd);
+}
+
 void vterm_render_ctrl_char(vterm_t *vterm,char c)
 {
    switch(c)
@@ -370,13 +1166,6 @@ void vterm_render_ctrl_char(vterm_t *vterm,char c)
          break;
       }
 
-      /* begin escape sequence (aborting previous one if any) */
-      case '\x1B':
-      {
-         vterm_escape_start(vterm);
-         break;
-      }
-
       /* enter graphical character mode */
       case '\x0E':
       {
@@ -391,26 +1180,11 @@ void vterm_render_ctrl_char(vterm_t *vterm,char c)
          break;
       }
 
-      /* CSI character. Equivalent to ESC [ */
-      case '\x9B':
-      {
-         vterm_escape_start(vterm);
-         vterm->esbuf[vterm->esbuf_len++]='[';
-         break;
-      }
-
-      /* these interrupt escape sequences */
-      case '\x18':
-      case '\x1A':
-      {
-         vterm_escape_cancel(vterm);
-         break;
-      }
-
       /* bell */
       case '\a':
       {
-         beep();
+         if(vterm->backend->bell != NULL)
+            vterm->backend->bell(vterm->backend_ctx);
          break;
       }
 
@@ -422,129 +1196,400 @@ void vterm_render_ctrl_char(vterm_t *vterm,char c)
    }
 }
 
+/* returns the length of the run of plain printable ascii (0x20-0x7e) at the
+ * start of data */
+int vterm_scan_printable(const char *data,int len)
+{
+   int i=0;
+
+#if defined(__AVX2__)
+   const __m256i  lo=_mm256_set1_epi8(0x1f);
+   const __m256i  hi=_mm256_set1_epi8(0x7f);
+
+   for(;i+32 <= len;i+=32)
+   {
+      /* bytes >= 0x80 are negative here, so the > 0x1f test drops them */
+      __m256i  v=_mm256_loadu_si256((const __m256i*)(data+i));
+      __m256i  ok=_mm256_and_si256(_mm256_cmpgt_epi8(v,lo),
+         _mm256_cmpgt_epi8(hi,v));
+      guint    mask=(guint)_mm256_movemask_epi8(ok);
+
+      if(mask != 0xffffffffu) return i+__builtin_ctz(~mask);
+   }
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+   const __m128i  lo16=_mm_set1_epi8(0x1f);
+   const __m128i  hi16=_mm_set1_epi8(0x7f);
+
+   for(;i+16 <= len;i+=16)
+   {
+      __m128i  v=_mm_loadu_si128((const __m128i*)(data+i));
+      __m128i  ok=_mm_and_si128(_mm_cmpgt_epi8(v,lo16),
+         _mm_cmplt_epi8(v,hi16));
+      guint    mask=(guint)_mm_movemask_epi8(ok);
+
+      if(mask != 0xffffu) return i+__builtin_ctz(~mask);
+   }
+#endif
+
+   for(;i < len;i++)
+   {
+      if(data[i] < 0x20 || data[i] > 0x7e) break;
+   }
+
+   return i;
+}
+
+/* writes a run of plain printable characters with the current attributes,
+ * only splitting it where the cursor wraps */
+void vterm_put_run(vterm_t *vterm,const char *data,int len)
+{
+   vterm_cell_t   *row;
+   vterm_cell_t   *cell;
+   int            n;
+   int            i;
+
+   while(len > 0)
+   {
+      if(vterm->ccol >= vterm->cols)
+      {
+         vterm->ccol=0;
+         vterm_scroll_down(vterm);
+      }
+
+      n=MIN(len,vterm->cols-vterm->ccol);
+      row=vterm_row(vterm,vterm->crow);
+      cell=row+vterm->ccol;
+
+      /* wide chars cut at either end of the run lose their other half */
+      if(cell[0].attr & VTERM_ATTR_WIDE_CONT)
+         vterm_split_wide(vterm,vterm->crow,vterm->ccol);
+      if(cell[n-1].attr & VTERM_ATTR_WIDE)
+         vterm_split_wide(vterm,vterm->crow,vterm->ccol+n-1);
+
+      for(i=0;i < n;i++)
+      {
+         cell[i].ch=(guint8)data[i];
+         cell[i].attr=vterm->curattr;
+      }
+
+      vterm_dirty_span(vterm,vterm->crow,vterm->ccol,vterm->ccol+n-1);
+
+      vterm->ccol+=n;
+      data+=n;
+      len-=n;
+   }
+
+   return;
+}
+
 void vterm_render(vterm_t *vterm,const char *data,int len)
 {
-   int i;
+   int n;
 
-   for (i = 0; i < len; i++, data++)
+   while(len > 0)
    {
-      /* completely ignore NUL */
-      if(*data == 0) continue;
+      /* fast path for runs of plain text outside escapes, acs mode and
+       * multi byte chars */
+      if(vterm->pstate == PS_GROUND && vterm->utf8_left == 0 &&
+         !(vterm->state & STATE_ALT_CHARSET))
+      {
+         n=vterm_scan_printable(data,len);
+         if(n > 0)
+         {
+            vterm_put_run(vterm,data,n);
+            data+=n;
+            len-=n;
+            continue;
+         }
+      }
 
-      if(*data >= 1 && *data <= 31)
+      vterm_parse_byte(vterm,(guint8)*data);
+      data++;
+      len--;
+   }
+}
+
+/*
+   folds the ':' sub-parameters of the last CSI parameter into the list.
+   extended colors (38:5:n, 38:2:r:g:b or 38:2:cs:r:g:b, 48 alike) become
+   their ';' form, any other group (e.g. 4:3 curly underline) is ignored
+   as a whole rather than read as separate parameters
+*/
+static void vterm_fold_sub_params(vterm_t *vterm)
+{
+   gint  *sub=vterm->csi_sub;
+   gint  nsub=MIN(vterm->csi_subcount,MAX_CSI_SUB_PARAMS);
+   gint  head;
+   gint  add[4];
+   gint  count=0;
+   gint  i;
+
+   if(vterm->csi_subcount == 0) return;
+   vterm->csi_subcount=0;
+
+   head=vterm->csi_param[vterm->csi_pcount-1];
+   if(head == 38 || head == 48)
+   {
+      if(nsub >= 2 && sub[0] == 5)
       {
-         vterm_render_ctrl_char(vterm,*data);
-         continue;
+         add[0]=5;
+         add[1]=sub[1];
+         count=2;
       }
+      else if(nsub >= 4 && sub[0] == 2)
+      {
+         add[0]=2;
+         for(i=1;i <= 3;i++) add[i]=sub[(nsub >= 5) ? i + 1 : i];
+         count=4;
+      }
+   }
+
+   if(count == 0 || vterm->csi_pcount + count > MAX_CSI_ES_PARAMS)
+   {
+      vterm->csi_pcount--;
+      vterm->csi_dropped=TRUE;
+      return;
+   }
+
+   for(i=0;i < count;i++)
+      vterm->csi_param[vterm->csi_pcount++]=add[i];
+
+   return;
+}
+
+void vterm_parse_byte(vterm_t *vterm,guint8 c)
+{
+   guint8   entry;
+   gint     *param;
 
-      if(IS_MODE_ESCAPED(vterm) && vterm->esbuf_len < ESEQ_BUF_SIZE)
+   /* a utf-8 sequence cut short by anything else is malformed */
+   if(vterm->utf8_left > 0 && (c & 0xc0) != 0x80)
+   {
+      vterm->utf8_left=0;
+      vterm_put_char(vterm,0xfffd);
+   }
+
+   entry=vterm_parse_table[vterm->pstate]
+      [c < 0x80 ? vterm_byte_class[c] : (guint8)CC_HIGH];
+
+   switch(entry >> 4)
+   {
+      case PA_PRINT:
       {
-         /* append character to ongoing escape sequence */
-         vterm->esbuf[vterm->esbuf_len]=*data;
-         vterm->esbuf[++vterm->esbuf_len]=0;
+         if(c >= 0x80) vterm_put_utf8(vterm,c);
+         else vterm_put_char(vterm,c);
+         break;
+      }
 
-         try_interpret_escape_seq(vterm);
+      case PA_EXEC:
+      {
+         vterm_render_ctrl_char(vterm,c);
+         break;
       }
-      else
+
+      case PA_CLEAR:
+      {
+         vterm->esc_private=0;
+         vterm->esc_inter_len=0;
+         vterm->csi_param[0]=0;
+         vterm->csi_pcount=0;
+         vterm->csi_subcount=0;
+         vterm->csi_dropped=FALSE;
+         break;
+      }
+
+      case PA_COLLECT:
       {
-        	vterm_put_char(vterm,*data);
+         if(c >= 0x3c && c <= 0x3f)
+         {
+            vterm->esc_private=c;
+         }
+         else if(vterm->esc_inter_len < ESEQ_MAX_INTER)
+         {
+            vterm->esc_inter[vterm->esc_inter_len++]=c;
+         }
+         break;
+      }
+
+      case PA_PARAM:
+      {
+         if(vterm->csi_pcount == 0) vterm->csi_pcount=1;
+
+         /* ':' starts a sub-parameter of the current parameter, they are
+            collected apart and folded in once the parameter ends */
+         if(c == ':')
+         {
+            if(vterm->csi_subcount < MAX_CSI_SUB_PARAMS)
+               vterm->csi_sub[vterm->csi_subcount]=0;
+            vterm->csi_subcount++;
+            break;
+         }
+
+         if(c == ';')
+         {
+            vterm_fold_sub_params(vterm);
+
+            /* extra parameters beyond the limit are dropped */
+            if(vterm->csi_pcount < MAX_CSI_ES_PARAMS)
+            {
+               vterm->csi_param[vterm->csi_pcount++]=0;
+            }
+            break;
+         }
+
+         if(vterm->csi_subcount > MAX_CSI_SUB_PARAMS) break;
+         if(vterm->csi_subcount > 0)
+            param=&vterm->csi_sub[vterm->csi_subcount-1];
+         else
+            param=&vterm->csi_param[vterm->csi_pcount-1];
+         if(*param < 10000) *param=(*param * 10)+(c-'0');
+         break;
+      }
+
+      case PA_ESC_DISPATCH:
+      {
+         vterm_interpret_esc(vterm,c);
+         break;
+      }
+
+      case PA_CSI_DISPATCH:
+      {
+         /* a sequence left with no parameters after ignoring some would
+            read as the all defaults form, so it is dropped instead */
+         vterm_fold_sub_params(vterm);
+         if(vterm->csi_dropped && vterm->csi_pcount == 0) break;
+
+         vterm->esc_final=c;
+         vterm_interpret_csi(vterm);
+         break;
       }
    }
+
+   vterm->pstate=entry & 0x0f;
+
+   return;
 }
 
-void vterm_escape_start(vterm_t *vterm)
-{
-   vterm->state |= STATE_ESCAPE_MODE;
-   vterm->esbuf_len=0;
-   vterm->esbuf[0]='\0';
+/* interprets an escape sequence that is not a CSI or string sequence */
+void vterm_interpret_esc(vterm_t *vterm,char final)
+{
+   /* designate G0 character set: ESC ( 0 is line drawing, others are text */
+   if(vterm->esc_inter_len == 1 && vterm->esc_inter[0] == '(')
+   {
+      if(final == '0') vterm->state |= STATE_ALT_CHARSET;
+      else vterm->state &= ~STATE_ALT_CHARSET;
+      return;
+   }
+
+   if(vterm->esc_inter_len) return;
+
+   switch(final)
+   {
+      /* reverse line-feed */
+      case 'M': vterm_scroll_up(vterm); break;
+
+      /* save / restore cursor (DECSC / DECRC) */
+      case '7': interpret_csi_SAVECUR(vterm,NULL,0); break;
+      case '8': interpret_csi_RESTORECUR(vterm,NULL,0); break;
+   }
 
    return;
 }
 
-void vterm_escape_cancel(vterm_t *vterm)
+/*
+   Cell spans
+
+   Erasing and shifting cells works on whole spans of a row. Fills store a
+   prebuilt blank cell several cells at a time and moves are one memmove,
+   the span helpers also mark the cells they change dirty.
+*/
+
+/* fills count cells with blanks of the given attributes */
+void vterm_fill_cells(vterm_cell_t *cells,int count,guint32 attr)
 {
-   vterm->state &= ~STATE_ESCAPE_MODE;
-   vterm->esbuf_len=0;
-   vterm->esbuf[0]='\0';
+   vterm_cell_t   blank;
+   guint64        bits;
+   int            i=0;
+
+   blank.ch=0x20;
+   blank.attr=attr;
+   memcpy(&bits,&blank,sizeof(bits));
+
+#if defined(__AVX2__)
+   const __m256i  v=_mm256_set1_epi64x((long long)bits);
+
+   for(;i+4 <= count;i+=4)
+      _mm256_storeu_si256((__m256i*)(cells+i),v);
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+   const __m128i  v16=_mm_set1_epi64x((long long)bits);
+
+   for(;i+2 <= count;i+=2)
+      _mm_storeu_si128((__m128i*)(cells+i),v16);
+#endif
+
+   for(;i < count;i++) cells[i]=blank;
 
    return;
 }
 
-void try_interpret_escape_seq(vterm_t *vterm)
+/* blanks count cells of row r starting at col, clipped to the row. a wide
+ * char cut at either end of the span loses its other half */
+void vterm_fill_span(vterm_t *vterm,int r,int col,int count,guint32 attr)
 {
-   char  firstchar=vterm->esbuf[0];
-   char  lastchar=vterm->esbuf[vterm->esbuf_len-1];
-
-   /* too early to do anything */
-   if(!firstchar) return;
-
-   /* interpret ESC-M as reverse line-feed */
-   if(firstchar=='M')
+   if(col < 0)
    {
-      vterm_scroll_up(vterm);
-      vterm_escape_cancel(vterm);
-      return;
+      count+=col;
+      col=0;
    }
+   if(count > vterm->cols-col) count=vterm->cols-col;
+   if(count <= 0) return;
 
-   if(firstchar != '[' && firstchar != ']')
-   {
-      vterm_escape_cancel(vterm);
-      return;
-   }
+   vterm_split_wide(vterm,r,col);
+   vterm_split_wide(vterm,r,col+count-1);
 
-   /* we have a csi escape sequence: interpret it */
-   if(firstchar == '[' && validate_escape_suffix(lastchar))
-   {
-      vterm_interpret_csi(vterm);
-      vterm_escape_cancel(vterm);
-   }
-   /* we have an xterm escape sequence: interpret it */
-   else if(firstchar == ']' && lastchar == '\a')
-   {
-      vterm_escape_cancel(vterm);
-   }
+   vterm_fill_cells(vterm_row(vterm,r)+col,count,attr);
+   vterm_dirty_span(vterm,r,col,col+count-1);
 
-   /* if the escape sequence took up all available space and could
-    * not yet be parsed, abort it */
-   if(vterm->esbuf_len + 1 >= ESEQ_BUF_SIZE) vterm_escape_cancel(vterm);
+   return;
+}
+
+/* moves count cells of row r from src_col to dst_col, the spans may
+ * overlap */
+void vterm_move_span(vterm_t *vterm,int r,int dst_col,int src_col,int count)
+{
+   vterm_cell_t   *row;
+
+   if(count <= 0) return;
+
+   row=vterm_row(vterm,r);
+   memmove(row+dst_col,row+src_col,sizeof(vterm_cell_t)*count);
+   vterm_dirty_span(vterm,r,dst_col,dst_col+count-1);
 
    return;
 }
 
 void vterm_erase(vterm_t *vterm)
 {
-   int   cell_count;
-   int   x,y;
-   int   i;
-
    if(vterm == NULL) return;
 
-   cell_count=vterm->rows*vterm->cols;
-
-   for(i=0;i < cell_count;i++)
-   {
-      x=i%vterm->cols;
-      y=(int)(i/vterm->cols);
-      vterm->cells[y][x].ch=0x20;
-      vterm->cells[y][x].attr=COLOR_PAIR(vterm->colors);
-   }
+   vterm_fill_cells(vterm->cells,vterm->rows*vterm->cols,
+      VTERM_BLANK_ATTR(vterm));
+   vterm_dirty_rows(vterm,0,vterm->rows-1);
 
    return;
 }
 
 void vterm_erase_row(vterm_t *vterm,gint row)
 {
-   gint  i;
-
    if(vterm == NULL) return;
 
    if(row == -1) row=vterm->crow;
 
-   for(i=0;i < vterm->cols;i++)
-   {
-      vterm->cells[row][i].ch=0x20;
-      vterm->cells[row][i].attr=COLOR_PAIR(vterm->colors);
-   }
+   vterm_fill_span(vterm,row,0,vterm->cols,VTERM_BLANK_ATTR(vterm));
 
    return;
 }
@@ -573,8 +1618,9 @@ void vterm_erase_col(vterm_t *vterm,gint col)
 
    for(i=0;i < vterm->rows;i++)
    {
-      vterm->cells[i][col].ch=0x20;
-      vterm->cells[i][col].attr=COLOR_PAIR(vterm->colors);
+      vterm_row(vterm,i)[col].ch=0x20;
+      vterm_row(vterm,i)[col].attr=VTERM_BLANK_ATTR(vterm);
+      vterm_dirty_span(vterm,i,col,col);
    }
 
    return;
@@ -582,73 +1628,191 @@ void vterm_erase_col(vterm_t *vterm,gint col)
 
 void vterm_erase_cols(vterm_t *vterm,gint start_col)
 {
+   gint  i;
+
    if(vterm == NULL) return;
    if(start_col < 0) return;
 
-   while(start_col < vterm->cols)
+   for(i=0;i < vterm->rows;i++)
    {
-      vterm_erase_col(vterm,start_col);
-      start_col++;
+      vterm_fill_span(vterm,i,start_col,vterm->cols-start_col,
+         VTERM_BLANK_ATTR(vterm));
    }
 
    return;
 }
 
+/* copies the rows of a screen grid into a new grid of blank cells, in
+ * logical order */
+static vterm_cell_t* vterm_resize_grid(vterm_t *vterm,vterm_cell_t *grid,
+   gint *map,guint width,guint height)
+{
+   vterm_cell_t   *cells;
+   gint           i;
+   gint           copy_rows;
+   gint           copy_cols;
+
+   cells=(vterm_cell_t*)g_malloc(sizeof(vterm_cell_t)*width*height);
+   vterm_fill_cells(cells,width*height,VTERM_BLANK_ATTR(vterm));
+
+   copy_rows=MIN((gint)height,vterm->rows);
+   copy_cols=MIN((gint)width,vterm->cols);
+
+   for(i=0;i < copy_rows;i++)
+   {
+      memcpy(cells+(i*width),grid+(map[i]*vterm->cols),
+         sizeof(vterm_cell_t)*copy_cols);
+
+      /* a wide char cut by the new right edge is blanked */
+      if(cells[(i*width)+copy_cols-1].attr & VTERM_ATTR_WIDE)
+      {
+         cells[(i*width)+copy_cols-1].ch=0x20;
+         cells[(i*width)+copy_cols-1].attr&=~VTERM_ATTR_WIDE;
+      }
+   }
+
+   g_free(grid);
+
+   return cells;
+}
+
 void vterm_resize(vterm_t *vterm,guint width,guint height)
 {
     struct winsize ws;
     ws.ws_xpixel = 0;
     ws.ws_ypixel = 0;
-   guint          i;
-   gint           delta_x;
-   gint           delta_y;
-   gint           start_x;
-   gint           start_y;
 
    if(vterm==NULL) return;
    if(width==0 || height==0) return;
 
-   delta_x=width-vterm->cols;
-   delta_y=height-vterm->rows;
-   start_x=vterm->cols;
-   start_y=vterm->rows;
+   /* both screens keep what fits, new cells are blank */
+   vterm->cells=vterm_resize_grid(vterm,vterm->cells,vterm->row_map,
+      width,height);
+   vterm->row_map=vterm_new_row_map(vterm->row_map,height);
 
-   vterm->cells=(vterm_cell_t**)g_realloc(vterm->cells,
-      sizeof(vterm_cell_t*)*height);
-
-   for(i=0;i < height;i++)
+   if(vterm->alt_cells != NULL)
    {
-      // realloc() does not initlize new elements
-      if((delta_y > 0) && (i > vterm->rows-1)) vterm->cells[i]=NULL;
-
-      vterm->cells[i]=(vterm_cell_t*)g_realloc(vterm->cells[i],
-         sizeof(vterm_cell_t)*width);
+      vterm->alt_cells=vterm_resize_grid(vterm,vterm->alt_cells,
+         vterm->alt_row_map,width,height);
+      vterm->alt_row_map=vterm_new_row_map(vterm->alt_row_map,height);
    }
 
+   vterm->dirty=(vterm_dirty_t*)g_realloc(vterm->dirty,
+      sizeof(vterm_dirty_t)*height);
+
    vterm->rows=height;
    vterm->cols=width;
+
+   vterm->view_row=(vterm_cell_t*)g_realloc(vterm->view_row,
+      sizeof(vterm_cell_t)*width);
+
    if(!(vterm->state & STATE_SCROLL_SHORT))
    {
       vterm->scroll_max=height-1;
    }
+   else
+   {
+      /* keep a short scrolling region inside the new window */
+      vterm->scroll_max=MIN(vterm->scroll_max,vterm->rows-1);
+      vterm->scroll_min=MIN(vterm->scroll_min,vterm->scroll_max);
+   }
+
+   /* a saved cursor must also stay inside the new window */
+   vterm->saved_x=MIN(vterm->saved_x,vterm->cols-1);
+   vterm->saved_y=MIN(vterm->saved_y,vterm->rows-1);
+   vterm->alt_saved_x=MIN(vterm->alt_saved_x,vterm->cols-1);
+   vterm->alt_saved_y=MIN(vterm->alt_saved_y,vterm->rows-1);
 
    ws.ws_row=height;
    ws.ws_col=width;
 
    clamp_cursor_to_bounds(vterm);
 
-   if(delta_x > 0) vterm_erase_cols(vterm,start_x);
-   if(delta_y > 0) vterm_erase_rows(vterm,start_y);
+   /* the window has new geometry so everything gets repainted */
+   vterm_dirty_clear(vterm);
+   vterm_dirty_rows(vterm,0,vterm->rows-1);
+   vterm->prow=vterm->crow;
+   vterm->pcol=vterm->ccol;
+
+   /* only a terminal that owns a pty has a child to tell */
+   if(vterm->child_pid > 0)
+   {
+      ioctl(vterm->pty_fd,TIOCSWINSZ,&ws);
+      kill(vterm->child_pid,SIGWINCH);
+   }
+
+   return;
+}
+
+/* shows the other screen, the grids are swapped so neither is copied */
+static void vterm_swap_screen(vterm_t *vterm)
+{
+   vterm_cell_t   *cells;
+   gint           *map;
+
+   if(vterm->alt_cells == NULL)
+   {
+      vterm->alt_cells=(vterm_cell_t*)g_malloc(sizeof(vterm_cell_t)*
+         vterm->rows*vterm->cols);
+      vterm_fill_cells(vterm->alt_cells,vterm->rows*vterm->cols,
+         VTERM_BLANK_ATTR(vterm));
+      vterm->alt_row_map=vterm_new_row_map(NULL,vterm->rows);
+   }
+
+   cells=vterm->cells;
+   vterm->cells=vterm->alt_cells;
+   vterm->alt_cells=cells;
+
+   map=vterm->row_map;
+   vterm->row_map=vterm->alt_row_map;
+   vterm->alt_row_map=map;
+
+   vterm->state ^= STATE_ALT_SCREEN;
+
+   /* the backend is still showing the other screen */
+   vterm_touch(vterm);
 
-   ioctl(vterm->pty_fd,TIOCSWINSZ,&ws);
-   kill(vterm->child_pid,SIGWINCH);
+   return;
+}
+
+/* 47 only switches screens, 1047 also clears the alternate screen when
+ * leaving it and 1049 clears it when entering, saving the cursor */
+void vterm_set_alt_screen(vterm_t *vterm,gint mode,gboolean enable)
+{
+   if(vterm==NULL) return;
+   if(enable == ((vterm->state & STATE_ALT_SCREEN) != 0)) return;
+
+   if(enable)
+   {
+      if(mode == 1049)
+      {
+         vterm->alt_saved_x=vterm->ccol;
+         vterm->alt_saved_y=vterm->crow;
+      }
+
+      vterm_swap_screen(vterm);
+      if(mode == 1049) vterm_erase(vterm);
+   }
+   else
+   {
+      if(mode == 1047) vterm_erase(vterm);
+      vterm_swap_screen(vterm);
+
+      if(mode == 1049)
+      {
+         vterm->ccol=vterm->alt_saved_x;
+         vterm->crow=vterm->alt_saved_y;
+         clamp_cursor_to_bounds(vterm);
+      }
+   }
 
    return;
 }
 
 void vterm_scroll_down(vterm_t *vterm)
 {
-   int i;
+   gint  *map=vterm->row_map;
+   gint  top;
 
    vterm->crow++;
 
@@ -658,13 +1822,21 @@ void vterm_scroll_down(vterm_t *vterm)
     * last line of it */
    vterm->crow=vterm->scroll_max;
 
-   for(i=vterm->scroll_min; i < vterm->scroll_max; i++)
+   vterm_dirty_rows(vterm,vterm->scroll_min,vterm->scroll_max);
+
+   /* lines leaving the top of the main screen go to the scrollback */
+   if(vterm->scroll_min == 0 && vterm->sb_max_lines > 0 &&
+      !(vterm->state & STATE_ALT_SCREEN))
    {
-      // vterm->dirty_lines[i]=TRUE;
-      memcpy(vterm->cells[i],vterm->cells[i+1],
-         sizeof(vterm_cell_t)*vterm->cols);
+      vterm_sb_push(vterm,vterm_row(vterm,0));
    }
 
+   /* the old top row of the region is reused as its bottom row */
+   top=map[vterm->scroll_min];
+   memmove(map+vterm->scroll_min,map+vterm->scroll_min+1,
+      sizeof(gint)*(vterm->scroll_max-vterm->scroll_min));
+   map[vterm->scroll_max]=top;
+
    /* clear last row of the scrolling region */
    vterm_erase_row(vterm,vterm->scroll_max);
 
@@ -673,7 +1845,8 @@ void vterm_scroll_down(vterm_t *vterm)
 
 void vterm_scroll_up(vterm_t *vterm)
 {
-   int i;
+   gint  *map=vterm->row_map;
+   gint  bottom;
 
    vterm->crow--;
 
@@ -683,12 +1856,13 @@ void vterm_scroll_up(vterm_t *vterm)
     * first line of it */
    vterm->crow=vterm->scroll_min;
 
-   for(i=vterm->scroll_max;i > vterm->scroll_min;i--)
-   {
-      // vterm->dirty_lines[i]=TRUE;
-      memcpy(vterm->cells[i],vterm->cells[i-1],
-         sizeof(vterm_cell_t)*vterm->cols);
-   }
+   vterm_dirty_rows(vterm,vterm->scroll_min,vterm->scroll_max);
+
+   /* the old bottom row of the region is reused as its top row */
+   bottom=map[vterm->scroll_max];
+   memmove(map+vterm->scroll_min+1,map+vterm->scroll_min,
+      sizeof(gint)*(vterm->scroll_max-vterm->scroll_min));
+   map[vterm->scroll_min]=bottom;
 
    /* clear first row of the scrolling region */
    vterm_erase_row(vterm,vterm->scroll_min);
@@ -699,65 +1873,34 @@ void vterm_scroll_up(vterm_t *vterm)
 //////////////////////////////////////////////////////////////////////////
 // CSI
 
-void vterm_interpret_csi(vterm_t *vterm) {
-   static int csiparam[MAX_CSI_ES_PARAMS];
-   int param_count = 0;
-   const char * p;
-   char verb;
+void vterm_interpret_csi(vterm_t *vterm)
+{
+   vterm_csi_fn   handler;
+   guint8         final=(guint8)vterm->esc_final;
 
-   p = vterm->esbuf+1;
-   verb = vterm->esbuf[vterm->esbuf_len-1];
+   /* no handlers take intermediates, and only the mode setters are
+    * interested in private (DEC) sequences */
+   if(vterm->esc_inter_len) return;
+   if(final < 0x40 || final > 0x7e) return;
 
-   // parse numeric parameters 
-   while ((*p >= '0' && *p <= '9') || *p == ';' || *p == '?') {
-      if (*p == '?') {
-         p++;
-         continue;
-      }
-      if(*p == ';') {
-         if (param_count >= MAX_CSI_ES_PARAMS) return; // too long
-         csiparam[param_count++]=0;
-      } else {
-         if (param_count==0) csiparam[param_count++] = 0;
-         csiparam[param_count-1] *= 10;
-         csiparam[param_count-1] += *p - '0';
-      }
-      p++;
-   }
-
-   // delegate handling depending on command character (verb)
-   switch (verb) {
-      case 'm': interpret_csi_SGR(vterm, csiparam, param_count); break;
-      case 'l': interpret_dec_RM(vterm, csiparam, param_count); break;
-      case 'h': interpret_dec_SM(vterm, csiparam, param_count); break;
-      case 'J': interpret_csi_ED(vterm, csiparam, param_count); break;
-      case 'H':
-      case 'f': interpret_csi_CUP(vterm, csiparam, param_count); break;
-      case 'A':
-      case 'B':
-      case 'C':
-      case 'D':
-      case 'E':
-      case 'F':
-      case 'G':
-      case 'e':
-      case 'a':
-      case 'd':
-      case '`': interpret_csi_CUx(vterm, verb, csiparam, param_count); break;
-      case 'K': interpret_csi_EL(vterm, csiparam, param_count); break;
-      case '@': interpret_csi_ICH(vterm, csiparam, param_count); break;
-      case 'P': interpret_csi_DCH(vterm, csiparam, param_count); break;
-      case 'L': interpret_csi_IL(vterm, csiparam, param_count); break;
-      case 'M': interpret_csi_DL(vterm, csiparam, param_count); break;
-      case 'X': interpret_csi_ECH(vterm, csiparam, param_count); break;
-      case 'r': interpret_csi_DECSTBM(vterm, csiparam, param_count); break;
-      case 's': interpret_csi_SAVECUR(vterm, csiparam, param_count); break;
-      case 'u': interpret_csi_RESTORECUR(vterm, csiparam, param_count); break;
+   if(vterm->esc_private)
+   {
+      if(vterm->esc_private != '?') return;
+      if(final != 'h' && final != 'l') return;
+   }
+
+   handler=vterm_csi_table[final-0x40];
+   if(handler == NULL)
+   {
 #ifdef DEBUG
-      default:
-         fprintf(stderr, "Unrecogized CSI: <%s>\n", rt->pd->esbuf); break;
+      fprintf(stderr, "Unrecognized CSI: <%c>\n", final);
 #endif
+      return;
    }
+
+   handler(vterm,vterm->csi_param,vterm->csi_pcount);
+
+   return;
 }
 
 /* interprets a 'move cursor' (CUP) escape sequence */
@@ -822,23 +1965,20 @@ void interpret_csi_CUx(vterm_t *vterm,char verb,int param[],int pcount)
 /* Interpret the 'delete chars' sequence (DCH) */
 void interpret_csi_DCH(vterm_t *vterm, int param[], int pcount)
 {
-   int i;
    int n=1;
 
    if(pcount && param[0] > 0) n=param[0]; 
 
-   for(i=vterm->ccol;i < vterm->cols;i++)
-   {
-      if(i+n < vterm->cols)
-      {
-         vterm->cells[vterm->crow][i]=vterm->cells[vterm->crow][i+n];
-      }
-      else
-      {
-         vterm->cells[vterm->crow][i].ch=0x20;
-         vterm->cells[vterm->crow][i].attr=vterm->curattr;
-      }
-   }
+   if(vterm->ccol >= vterm->cols) return;
+   n=MIN(n,vterm->cols-vterm->ccol);
+
+   vterm_split_wide(vterm,vterm->crow,vterm->ccol);
+   vterm_split_wide(vterm,vterm->crow,vterm->ccol+n-1);
+
+   /* the rest of the row slides left over the deleted cells */
+   vterm_move_span(vterm,vterm->crow,vterm->ccol,vterm->ccol+n,
+      vterm->cols-vterm->ccol-n);
+   vterm_fill_span(vterm,vterm->crow,vterm->cols-n,n,vterm->curattr);
 }
 
 /* Interpret a 'set scrolling region' (DECSTBM) sequence */
@@ -884,27 +2024,23 @@ void interpret_csi_DECSTBM(vterm_t *vterm,int param[],int pcount)
 /* Interpret a 'delete line' sequence (DL) */
 void interpret_csi_DL(vterm_t *vterm,int param[],int pcount)
 {
-   int i, j;
+   int i;
    int n=1;
 
    if(pcount && param[0] > 0) n=param[0];
 
+   vterm_dirty_rows(vterm,vterm->crow,vterm->scroll_max);
+
    for(i=vterm->crow;i <= vterm->scroll_max; i++)
    {
-      // vterm->dirty_lines[i]=TRUE;
-
       if(i+n <= vterm->scroll_max)
       {
-         memcpy(vterm->cells[i],vterm->cells[i+n],
+         memcpy(vterm_row(vterm,i),vterm_row(vterm,i+n),
             sizeof(vterm_cell_t)*vterm->cols);
       }
       else
       {
-         for(j=0;j < vterm->cols;j++)
-         {
-            vterm->cells[i][j].ch=0x20;
-            vterm->cells[i][j].attr=vterm->curattr;
-         }
+         vterm_fill_span(vterm,i,0,vterm->cols,vterm->curattr);
       }
    }
 
@@ -914,18 +2050,11 @@ void interpret_csi_DL(vterm_t *vterm,int param[],int pcount)
 /* Interpret an 'erase characters' (ECH) sequence */
 void interpret_csi_ECH(vterm_t *vterm,int param[],int pcount)
 {
-   int i;
    int n=1;
 
    if(pcount && param[0] > 0) n=param[0];
 
-   for(i=vterm->ccol;i < vterm->ccol+n; i++)
-   {
-      if(i >= vterm->cols) break;
-
-      vterm->cells[vterm->crow][i].ch=0x20;
-      vterm->cells[vterm->crow][i].attr=vterm->curattr;
-   }
+   vterm_fill_span(vterm,vterm->crow,vterm->ccol,n,vterm->curattr);
 
    return;
 }
@@ -933,47 +2062,46 @@ void interpret_csi_ECH(vterm_t *vterm,int param[],int pcount)
 /* interprets an 'erase display' (ED) escape sequence */
 void interpret_csi_ED(vterm_t *vterm, int param[], int pcount)
 {
-   int r, c;
-   int start_row, start_col, end_row, end_col;
+   int r;
+   int start_row, end_row;
+   int cmd=0;
 
-   /* decide range */
-   if(pcount && param[0]==2)
-   {
-      start_row=0;
-      start_col=0;
-      end_row=vterm->rows-1;
-      end_col=vterm->cols-1;
-   }
-   else if(pcount && param[0]==1)
-   {
-      start_row=0;
-      start_col=0;
-      end_row=vterm->crow;
-      end_col=vterm->ccol;
-   }
-   else
-   {
-      start_row=vterm->crow;
-      start_col=vterm->ccol;
-      end_row=vterm->rows-1;
-      end_col=vterm->cols-1;
-   }
+   if(pcount>0) cmd=param[0];
 
-   /* clean range */
-   for(r=start_row;r <= end_row;r++)
+   /* the cursor row is erased in part, the rows past it in full */
+   switch(cmd)
    {
-      for(c=start_col;c <= end_col;c++)
+      case 1:
+      {
+         start_row=0;
+         end_row=vterm->crow-1;
+         vterm_fill_span(vterm,vterm->crow,0,vterm->ccol+1,vterm->curattr);
+         break;
+      }
+      case 2:
+      {
+         start_row=0;
+         end_row=vterm->rows-1;
+         break;
+      }
+      default:
       {
-         vterm->cells[r][c].ch=0x20;               // erase with blanks.
-         vterm->cells[r][c].attr=vterm->curattr;   // set to current attributes.
+         start_row=vterm->crow+1;
+         end_row=vterm->rows-1;
+         vterm_fill_span(vterm,vterm->crow,vterm->ccol,
+            vterm->cols-vterm->ccol,vterm->curattr);
+         break;
       }
    }
+
+   for(r=start_row;r <= end_row;r++)
+      vterm_fill_span(vterm,r,0,vterm->cols,vterm->curattr);
 }
 
 /* Interpret the 'erase line' escape sequence */
 void interpret_csi_EL(vterm_t *vterm, int param[], int pcount)
 {
-   int erase_start, erase_end, i;
+   int erase_start, erase_end;
    int cmd=0;
 
    if(pcount>0) cmd=param[0];
@@ -1000,11 +2128,8 @@ void interpret_csi_EL(vterm_t *vterm, int param[], int pcount)
       }
    }
 
-   for(i=erase_start;i <= erase_end;i++)
-   {
-      vterm->cells[vterm->crow][i].ch = 0x20; 
-      vterm->cells[vterm->crow][i].attr = vterm->curattr;
-   }
+   vterm_fill_span(vterm,vterm->crow,erase_start,erase_end-erase_start+1,
+      vterm->curattr);
 
    return;
 }
@@ -1012,20 +2137,31 @@ void interpret_csi_EL(vterm_t *vterm, int param[], int pcount)
 /* Interpret the 'insert blanks' sequence (ICH) */
 void interpret_csi_ICH(vterm_t *vterm,int param[],int pcount)
 {
-   int i;
+   vterm_cell_t *row;
    int n=1;
 
    if(pcount && param[0]>0) n=param[0];
 
-   for (i=vterm->cols-1;i >= vterm->ccol+n;i--)
-   {
-      vterm->cells[vterm->crow][i]=vterm->cells[vterm->crow][i-n];
-   }
+   if(vterm->ccol >= vterm->cols) return;
+   n=MIN(n,vterm->cols-vterm->ccol);
+
+   row=vterm_row(vterm,vterm->crow);
 
-   for(i=vterm->ccol;i < vterm->ccol+n;i++)
+   /* a wide char split by the cursor loses its left half */
+   if(row[vterm->ccol].attr & VTERM_ATTR_WIDE_CONT)
+      vterm_split_wide(vterm,vterm->crow,vterm->ccol);
+
+   /* the rest of the row slides right, dropping what passes the edge */
+   vterm_move_span(vterm,vterm->crow,vterm->ccol+n,vterm->ccol,
+      vterm->cols-vterm->ccol-n);
+   vterm_fill_cells(row+vterm->ccol,n,vterm->curattr);
+   vterm_dirty_span(vterm,vterm->crow,vterm->ccol,vterm->ccol+n-1);
+
+   /* a wide char pushed to the edge loses its right half */
+   if(row[vterm->cols-1].attr & VTERM_ATTR_WIDE)
    {
-      vterm->cells[vterm->crow][i].ch=0x20;
-      vterm->cells[vterm->crow][i].attr = vterm->curattr;
+      row[vterm->cols-1].ch=' ';
+      row[vterm->cols-1].attr&=~VTERM_ATTR_WIDE;
    }
 
    return;
@@ -1034,14 +2170,16 @@ void interpret_csi_ICH(vterm_t *vterm,int param[],int pcount)
 /* Interpret an 'insert line' sequence (IL) */
 void interpret_csi_IL(vterm_t *vterm,int param[],int pcount)
 {
-   int i, j;
+   int i;
    int n=1;
 
    if(pcount && param[0] > 0) n=param[0];
 
+   vterm_dirty_rows(vterm,vterm->crow,vterm->scroll_max);
+
    for(i=vterm->scroll_max;i >= vterm->crow+n;i--)
    {
-      memcpy(vterm->cells[i],vterm->cells[i - n],
+      memcpy(vterm_row(vterm,i),vterm_row(vterm,i - n),
          sizeof(vterm_cell_t)*vterm->cols);
    }
 
@@ -1049,13 +2187,7 @@ void interpret_csi_IL(vterm_t *vterm,int param[],int pcount)
    {
       if(i>vterm->scroll_max) break;
 
-      // vterm->dirty_lines[i]=TRUE;
-
-      for(j=0;j < vterm->cols; j++)
-      {
-         vterm->cells[i][j].ch = 0x20;
-         vterm->cells[i][j].attr=vterm->curattr;
-      }
+      vterm_fill_span(vterm,i,0,vterm->cols,vterm->curattr);
    }
 
    return;
@@ -1101,16 +2233,26 @@ void interpret_csi_SAVECUR(vterm_t *vterm,int param[],int pcount)
    28    Invisible image off
 */
 
+/*
+   Colour SGR extensions (xterm)
+   30-37 / 40-47     set fg / bg from the 8 ansi colours
+   90-97 / 100-107   set fg / bg from the 8 bright colours
+   38;5;n / 48;5;n   set fg / bg from the 256 colour palette
+   38;2;r;g;b        set fg (or bg with 48) from a 24-bit colour, which is
+                     quantized to the nearest palette entry
+   39 / 49           default fg / bg
+*/
+
 /* interprets a 'set attribute' (SGR) CSI escape sequence */
 void interpret_csi_SGR(vterm_t *vterm, int param[], int pcount)
 {
    int   i;
-   short colors;
-   short default_fg,default_bg;
+   int   which;
+   int   color;
 
    if(pcount==0)
    {
-      vterm->curattr=A_NORMAL;                        // reset attributes
+      vterm_reset_attr(vterm);                        // reset attributes
       return;
    }
 
@@ -1118,31 +2260,31 @@ void interpret_csi_SGR(vterm_t *vterm, int param[], int pcount)
    {
       if(param[i]==0)                                 // reset attributes
       {
-         vterm->curattr=A_NORMAL;
+         vterm_reset_attr(vterm);
          continue;
       }
 
       if(param[i]==1 || param[i]==2 || param[i]==4)   // bold on
       {
-         vterm->curattr |= A_BOLD;
+         vterm->curattr |= VTERM_ATTR_BOLD;
          continue;
       }
 
       if(param[i]==5)                                 // blink on
       {
-         vterm->curattr |= A_BLINK;
+         vterm->curattr |= VTERM_ATTR_BLINK;
          continue;
       }
 
-      if(param[i]==7 || param[i]==27)                 // reverse on
+      if(param[i]==7)                                 // reverse on
       {
-         vterm->curattr |= A_REVERSE;
+         vterm->curattr |= VTERM_ATTR_REVERSE;
          continue;
       }
 
       if(param[i]==8)                                 // invisible on
       {
-         vterm->curattr |= A_INVIS;
+         vterm->curattr |= VTERM_ATTR_INVIS;
          continue;
       }
 
@@ -1160,101 +2302,235 @@ void interpret_csi_SGR(vterm_t *vterm, int param[], int pcount)
 
       if(param[i]==22 || param[i]==24)                // bold off
       {
-         vterm->curattr &= ~A_BOLD;
+         vterm->curattr &= ~VTERM_ATTR_BOLD;
          continue;
       }
 
       if(param[i]==25)                                // blink off
       {
-         vterm->curattr &= ~A_BLINK;
+         vterm->curattr &= ~VTERM_ATTR_BLINK;
+         continue;
+      }
+
+      if(param[i]==27)                                // reverse off
+      {
+         vterm->curattr &= ~VTERM_ATTR_REVERSE;
          continue;
       }
 
       if(param[i]==28)                                // invisible off
       {
-         vterm->curattr &= ~A_INVIS;
+         vterm->curattr &= ~VTERM_ATTR_INVIS;
          continue;
       }
 
       if(param[i] >= 30 && param[i] <= 37)            // set fg color
       {
          vterm->fg=param[i]-30;
-         colors=find_color_pair(vterm->fg,vterm->bg);
-         if(colors==-1) colors=0;
-         vterm->curattr |= COLOR_PAIR(colors);
+         vterm_update_color_attr(vterm);
          continue;
       }
 
       if(param[i] >= 40 && param[i] <= 47)            // set bg color
       {
          vterm->bg=param[i]-40;
-         colors=find_color_pair(vterm->fg,vterm->bg);
-         if(colors==-1) colors=0;
-         vterm->curattr |= COLOR_PAIR(colors);
+         vterm_update_color_attr(vterm);
+         continue;
+      }
+
+      if(param[i] >= 90 && param[i] <= 97)            // set bright fg color
+      {
+         vterm->fg=param[i]-90+8;
+         vterm_update_color_attr(vterm);
+         continue;
+      }
+
+      if(param[i] >= 100 && param[i] <= 107)          // set bright bg color
+      {
+         vterm->bg=param[i]-100+8;
+         vterm_update_color_attr(vterm);
+         continue;
+      }
+
+      if(param[i]==38 || param[i]==48)                // extended fg / bg
+      {
+         which=param[i];
+
+         if(i+2 < pcount && param[i+1]==5)
+         {
+            color=CLAMP(param[i+2],0,255);
+            i+=2;
+         }
+         else if(i+4 < pcount && param[i+1]==2)
+         {
+            color=vterm_color_from_rgb(param[i+2],param[i+3],param[i+4]);
+            i+=4;
+         }
+         else break;                                  // malformed
+
+         if(which==38) vterm->fg=color;
+         else vterm->bg=color;
+
+         vterm_update_color_attr(vterm);
          continue;
       }
 
       if(param[i]==39)                                // reset fg color
       {
-         pair_content(vterm->colors,&default_fg,&default_bg);
-         vterm->fg=default_fg;
-         colors=find_color_pair(vterm->fg,vterm->bg);
-         if(colors==-1) colors=0;
-         vterm->curattr |= COLOR_PAIR(colors);
+         vterm->fg=vterm->default_fg;
+         vterm_update_color_attr(vterm);
          continue;
       }
 
       if(param[i]==49)                                // reset bg color
       {
-         pair_content(vterm->colors,&default_fg,&default_bg);
-         vterm->bg=default_bg;
-         colors=find_color_pair(vterm->fg,vterm->bg);
-         if(colors==-1) colors=0;
-         vterm->curattr |= COLOR_PAIR(colors);
+         vterm->bg=vterm->default_bg;
+         vterm_update_color_attr(vterm);
          continue;
       }
    }
 }
 
-int vterm_set_colors(vterm_t *vterm,short fg,short bg)
+/* resets attributes and colors to the terminal defaults */
+void vterm_reset_attr(vterm_t *vterm)
 {
-   short colors;
+   vterm->fg=vterm->default_fg;
+   vterm->bg=vterm->default_bg;
+   vterm->curattr=VTERM_BLANK_ATTR(vterm);
 
-   if(vterm==NULL) return -1;
-   if(has_colors()==FALSE) return -1;
+   return;
+}
+
+/* replaces the colors in the current attributes with the current fg/bg */
+void vterm_update_color_attr(vterm_t *vterm)
+{
+   vterm->curattr=(vterm->curattr & ~VTERM_ATTR_COLOR_MASK) |
+      VTERM_ATTR_COLOR(vterm->fg,vterm->bg);
+
+   return;
+}
 
-   colors=find_color_pair(fg,bg);
-   if(colors==-1) colors=0;
+/* sets the colors used for blank cells and by SGR 0 / 39 / 49 */
+int vterm_set_colors(vterm_t *vterm,short fg,short bg)
+{
+   if(vterm==NULL) return -1;
 
-   vterm->colors=colors;
+   vterm->default_fg=CLAMP(fg,-1,255);
+   vterm->default_bg=CLAMP(bg,-1,255);
 
    return 0;
 }
 
-short vterm_get_colors(vterm_t *vterm)
+void vterm_get_colors(vterm_t *vterm,short *fg,short *bg)
 {
-   if(vterm==NULL) return -1;
-   if(has_colors()==FALSE) return -1;
+   if(vterm==NULL) return;
+
+   if(fg != NULL) *fg=vterm->default_fg;
+   if(bg != NULL) *bg=vterm->default_bg;
+
+   return;
+}
+
+/*
+   Palette
+
+   Colors are indexes into the xterm 256 color palette, these helpers give
+   their rgb values so backends with fewer colors can pick the nearest.
+*/
+
+/* standard xterm values for the 16 ansi colors */
+static const guint8 vterm_ansi_rgb[16][3]=
+{
+   {  0,  0,  0}, {205,  0,  0}, {  0,205,  0}, {205,205,  0},
+   {  0,  0,238}, {205,  0,205}, {  0,205,205}, {229,229,229},
+   {127,127,127}, {255,  0,  0}, {  0,255,  0}, {255,255,  0},
+   { 92, 92,255}, {255,  0,255}, {  0,255,255}, {255,255,255},
+};
+
+static const guint8 vterm_cube_levels[6]={0,95,135,175,215,255};
+
+/* returns the rgb value of a 256 color palette entry */
+void vterm_color_rgb(int color,int *r,int *g,int *b)
+{
+   if(color < 16)
+   {
+      *r=vterm_ansi_rgb[color][0];
+      *g=vterm_ansi_rgb[color][1];
+      *b=vterm_ansi_rgb[color][2];
+   }
+   else if(color < 232)
+   {
+      color-=16;
+      *r=vterm_cube_levels[(color/36)%6];
+      *g=vterm_cube_levels[(color/6)%6];
+      *b=vterm_cube_levels[color%6];
+   }
+   else
+   {
+      *r=*g=*b=8+(color-232)*10;
+   }
 
-   return vterm->colors;
+   return;
 }
 
-short find_color_pair(short fg,short bg)
+int vterm_color_dist(int r1,int g1,int b1,int r2,int g2,int b2)
 {
-   short fg_color,bg_color;
-   int   i;
+   return (r1-r2)*(r1-r2)+(g1-g2)*(g1-g2)+(b1-b2)*(b1-b2);
+}
 
-   if(has_colors()==FALSE) return -1;
+/* returns the index of the closest entry to [first,last) of the palette */
+int vterm_color_nearest(int r,int g,int b,int first,int last)
+{
+   int   i;
+   int   best=first;
+   int   best_dist=INT_MAX;
+   int   pr,pg,pb;
+   int   dist;
 
-   for(i=1;i<COLOR_PAIRS;i++)
+   for(i=first;i < last;i++)
    {
-      pair_content(i,&fg_color,&bg_color);
-      if(fg_color==fg && bg_color==bg) break;
+      vterm_color_rgb(i,&pr,&pg,&pb);
+      dist=vterm_color_dist(r,g,b,pr,pg,pb);
+      if(dist < best_dist)
+      {
+         best=i;
+         best_dist=dist;
+      }
    }
 
-   if(i==COLOR_PAIRS) return -1;
+   return best;
+}
+
+/* quantizes a 24-bit color to the 256 color palette */
+short vterm_color_from_rgb(int r,int g,int b)
+{
+   int   ri,gi,bi;
+   int   gray;
+   int   cube,gray_idx;
+   int   cr,cg,cb;
+   int   gr,gg,gb;
+
+   r=CLAMP(r,0,255);
+   g=CLAMP(g,0,255);
+   b=CLAMP(b,0,255);
 
-   return i;
+   /* closest point in the 6x6x6 cube */
+   ri=(r < 48) ? 0 : (r < 115) ? 1 : (r-35)/40;
+   gi=(g < 48) ? 0 : (g < 115) ? 1 : (g-35)/40;
+   bi=(b < 48) ? 0 : (b < 115) ? 1 : (b-35)/40;
+   cube=16+(36*ri)+(6*gi)+bi;
+
+   /* closest point on the grayscale ramp */
+   gray=(r+g+b)/3;
+   gray_idx=(gray < 8) ? 232 : (gray > 238) ? 255 : 232+((gray-8)/10);
+
+   vterm_color_rgb(cube,&cr,&cg,&cb);
+   vterm_color_rgb(gray_idx,&gr,&gg,&gb);
+
+   if(vterm_color_dist(r,g,b,gr,gg,gb) < vterm_color_dist(r,g,b,cr,cg,cb))
+      return gray_idx;
+
+   return cube;
 }
 
 /* Interpret DEC SM (set mode) */
@@ -1268,6 +2544,9 @@ void interpret_dec_SM(vterm_t *vterm,int param[],int pcount)
    {
       /* civis is actually "normal" for rxvt */
       if(param[i]==25) vterm->state &= ~STATE_CURSOR_INVIS;
+      if(param[i]==2004) vterm->state |= STATE_BRACKET_PASTE;
+      if(param[i]==47 || param[i]==1047 || param[i]==1049)
+         vterm_set_alt_screen(vterm,param[i],TRUE);
    }
 }
 
@@ -1282,5 +2561,8 @@ void interpret_dec_RM(vterm_t *vterm,int param[],int pcount)
    {
       /* civis is actually the "normal" vibility for rxvt   */
       if(param[i]==25) vterm->state |= STATE_CURSOR_INVIS;
+      if(param[i]==2004) vterm->state &= ~STATE_BRACKET_PASTE;
+      if(param[i]==47 || param[i]==1047 || param[i]==1049)
+         vterm_set_alt_screen(vterm,param[i],FALSE);
    }
 }
@@ -12,21 +12,77 @@
 
 #define LIBVTERM_VERSION "0.99.7"
 #define VTERM_FLAG_VT100 (1<<1)
-#define ESEQ_BUF_SIZE 128                // size of escape sequence buffer.
+#define ESEQ_MAX_INTER 2                 // max escape intermediate bytes
 
 #define STATE_ALT_CHARSET     (1<<1)
-#define STATE_ESCAPE_MODE     (1<<2)
 #define STATE_PIPE_ERR        (1<<3)
 #define STATE_CHILD_EXITED    (1<<4)
 #define STATE_CURSOR_INVIS    (1<<5)
 #define STATE_SCROLL_SHORT    (1<<6)      // scrolling region is not full height
+#define STATE_BRACKET_PASTE   (1<<7)      // remote wants pastes bracketed
+#define STATE_ALT_SCREEN      (1<<8)      // alternate screen is showing
 
-#define IS_MODE_ESCAPED(x)    (x->state & STATE_ESCAPE_MODE)
 #define IS_MODE_ACS(x)        (x->state & STATE_ALT_CHARSET)
 
-struct vterm_cell_t;
+/*
+   Cell attributes
+
+   The emulator keeps its own attribute encoding so the screen model has no
+   dependency on a curses screen. The low byte holds the VTERM_ATTR_* flags,
+   the foreground and background colors are packed above it as palette
+   index + 1 (0 is the terminal's default color). A double width char takes
+   two cells, the second is only a placeholder marked VTERM_ATTR_WIDE_CONT.
+*/
+
+#define VTERM_ATTR_BOLD       (1<<0)
+#define VTERM_ATTR_BLINK      (1<<1)
+#define VTERM_ATTR_REVERSE    (1<<2)
+#define VTERM_ATTR_INVIS      (1<<3)
+#define VTERM_ATTR_ACS        (1<<4)      // ch is a vt100 line drawing char
+#define VTERM_ATTR_FLAGS      0xff
+
+#define VTERM_ATTR_COLOR_MASK (0x3ffffu << 8)
+#define VTERM_ATTR_COLOR(fg,bg)                                   \
+   (((guint32)((fg)+1) << 8) | ((guint32)((bg)+1) << 17))
+#define VTERM_ATTR_FG(attr)   ((gint)(((attr) >> 8) & 0x1ff)-1)
+#define VTERM_ATTR_BG(attr)   ((gint)(((attr) >> 17) & 0x1ff)-1)
+
+#define VTERM_ATTR_WIDE       (1u<<26)    // ch is two columns wide
+#define VTERM_ATTR_WIDE_CONT  (1u<<27)    // right half of the cell before
+#define VTERM_ATTR_STYLE      (VTERM_ATTR_FLAGS | VTERM_ATTR_COLOR_MASK)
+
+struct vterm_cell_t {
+   guint32        ch;                           // unicode code point
+   guint32        attr;                         // VTERM_ATTR_* and colors
+};
+
 struct vterm_t;
 
+/*
+   Output backends
+
+   The emulator only maintains screen state. Whenever vterm_update() is
+   called the cells that changed since the previous update are handed to
+   the backend one span at a time, then the backend is told the update is
+   complete. The cursor is sent as a single cell drawn in reverse video.
+*/
+
+struct vterm_backend_t {
+   /* paint count cells starting at row,col */
+   void  (*draw)(void *ctx,int row,int col,const vterm_cell_t *cells,
+            int count);
+   /* ring the bell */
+   void  (*bell)(void *ctx);
+   /* end of an update, may be NULL */
+   void  (*flush)(void *ctx);
+};
+
+struct vterm_ansi_t;
+
+extern const vterm_backend_t vterm_null_backend;      // discards output
+extern const vterm_backend_t vterm_curses_backend;    // ctx is a WINDOW*
+extern const vterm_backend_t vterm_ansi_backend;      // ctx is a vterm_ansi_t*
+
 vterm_t*     vterm_create(guint width, guint height, guint flags);
 void         vterm_destroy(vterm_t *vterm);
 pid_t        vterm_get_pid(vterm_t *vterm);
@@ -36,12 +92,28 @@ const char*  vterm_get_ttyname(vterm_t *vterm);
 void         vterm_remote_read(vterm_t * term, const char * buf, int len);
 void         vterm_write_pipe(vterm_t *vterm, guint32 keycode);
 
+void         vterm_set_backend(vterm_t *vterm,
+                const vterm_backend_t *backend, void *ctx);
+void         vterm_update(vterm_t *vterm);
+void         vterm_touch(vterm_t *vterm);
+
+const vterm_cell_t* vterm_get_cell(vterm_t *vterm, int row, int col);
+void         vterm_get_cursor(vterm_t *vterm, int *row, int *col);
+gboolean     vterm_get_bracketed_paste(vterm_t *vterm);
+
+// curses backend
 void         vterm_wnd_set(vterm_t *vterm,WINDOW *window);
 WINDOW*      vterm_wnd_get(vterm_t *vterm);
-void         vterm_wnd_update(vterm_t *vterm);
+
+// ansi backend, diffs frames itself and writes escape sequences to fd
+vterm_ansi_t* vterm_ansi_create(int fd, int rows, int cols);
+void         vterm_ansi_destroy(vterm_ansi_t *ansi);
+void         vterm_ansi_resize(vterm_ansi_t *ansi, int rows, int cols);
+void         vterm_ansi_invalidate(vterm_ansi_t *ansi);
+gsize        vterm_ansi_get_bytes(vterm_ansi_t *ansi);
 
 int          vterm_set_colors(vterm_t *vterm, short fg, short bg);
-short        vterm_get_colors(vterm_t *vterm);
+void         vterm_get_colors(vterm_t *vterm, short *fg, short *bg);
 
 void         vterm_erase(vterm_t *vterm);
 void         vterm_erase_row(vterm_t *vterm,int row);
@@ -51,33 +123,67 @@ void         vterm_erase_cols(vterm_t *vterm, int start_cols);
 void         vterm_scroll_up(vterm_t *vterm);
 void         vterm_scroll_down(vterm_t *vterm);
 
+// alternate screen (DEC modes 47, 1047 and 1049)
+void         vterm_set_alt_screen(vterm_t *vterm, gint mode, gboolean enable);
+
 void         vterm_resize(vterm_t *vterm,guint width,guint height);
 
+// scrollback (0 lines disables it, 0 bytes is no byte limit)
+void         vterm_set_scrollback(vterm_t *vterm, guint max_lines,
+                gsize max_bytes);
+gint         vterm_scroll_view(vterm_t *vterm, gint lines);
+void         vterm_scroll_view_reset(vterm_t *vterm);
+gint         vterm_get_view_offset(vterm_t *vterm);
+
 // private
 
-#define VTERM_CELL(vterm_ptr,x,y)               ((y*vterm_ptr->cols)+x)
+#define VTERM_CELL(vterm_ptr,x,y)               \
+   (((((y)+(vterm_ptr)->row_top)%(vterm_ptr)->rows)*(vterm_ptr)->cols)+(x))
 
-bool  validate_escape_suffix(char c);
 void  clamp_cursor_to_bounds(vterm_t *vterm);
 
+/* returns the ctx of the vterm's backend if it is the given backend */
+void* vterm_get_backend_ctx(vterm_t *vterm,const vterm_backend_t *backend);
+
+// scrollback
+struct vterm_sb_line_t;
+
+void  vterm_sb_push(vterm_t *vterm,const vterm_cell_t *row);
+void  vterm_sb_decode(vterm_t *vterm,const vterm_sb_line_t *line,
+         vterm_cell_t *row);
+void  vterm_update_view(vterm_t *vterm);
+
+// cell spans
+void  vterm_fill_cells(vterm_cell_t *cells,int count,guint32 attr);
+void  vterm_fill_span(vterm_t *vterm,int row,int col,int count,
+         guint32 attr);
+void  vterm_move_span(vterm_t *vterm,int row,int dst_col,int src_col,
+         int count);
+
+// dirty tracking
+void  vterm_dirty_span(vterm_t *vterm,int row,int start_col,int end_col);
+void  vterm_dirty_rows(vterm_t *vterm,int start_row,int end_row);
+void  vterm_dirty_clear(vterm_t *vterm);
+
 void  vterm_write_rxvt(vterm_t *vterm,guint32 keycode);
 void  vterm_write_vt100(vterm_t *vterm,guint32 keycode);
 
 void vterm_render(vterm_t *,const char *data,int len);
-void vterm_put_char(vterm_t *vterm,chtype c);
+int  vterm_scan_printable(const char *data,int len);
+void vterm_put_run(vterm_t *vterm,const char *data,int len);
+void vterm_put_char(vterm_t *vterm,guint32 c);
 void vterm_render_ctrl_char(vterm_t *vterm,char c);
-void try_interpret_escape_seq(vterm_t *vterm);
 
 // escape
-void  vterm_escape_start(vterm_t *vterm);
-void  vterm_escape_cancel(vterm_t *vterm);
-void  try_interpret_escape_seq(vterm_t *vterm);
+void  vterm_parse_byte(vterm_t *vterm,guint8 c);
+void  vterm_interpret_esc(vterm_t *vterm,char final);
 
 // CSI
 
 #define MAX_CSI_ES_PARAMS 32
+#define MAX_CSI_SUB_PARAMS 8
 
-/* interprets a CSI escape sequence stored in buffer  */
+/* interprets the CSI sequence collected by the parser */
 void  vterm_interpret_csi(vterm_t *vterm);
 
 void  interpret_dec_SM(vterm_t *vterm,int param[],int pcount);
@@ -85,7 +191,6 @@ void  interpret_dec_RM(vterm_t *vterm,int param[],int pcount);
 void  interpret_csi_SGR(vterm_t *vterm,int param[],int pcount);
 void  interpret_csi_ED(vterm_t *vterm,int param[],int pcount);
 void  interpret_csi_CUP(vterm_t *vterm,int param[],int pcount);
-void  interpret_csi_ED(vterm_t *vterm,int param[],int pcount);
 void  interpret_csi_EL(vterm_t *vterm,int param[],int pcount);
 void  interpret_csi_ICH(vterm_t *vterm,int param[],int pcount);
 void  interpret_csi_DCH(vterm_t *vterm,int param[],int pcount);
@@ -97,6 +202,18 @@ void  interpret_csi_DECSTBM(vterm_t *vterm,int param[],int pcount);
 void  interpret_csi_SAVECUR(vterm_t *vterm,int param[],int pcount);
 void  interpret_csi_RESTORECUR(vterm_t *vterm,int param[],int pcount);
 
+// colors
+
+#define VTERM_MAX_PAIRS 256              // COLOR_PAIR() has 8 bits in a chtype
+
+void  vterm_reset_attr(vterm_t *vterm);
+void  vterm_update_color_attr(vterm_t *vterm);
+void  vterm_color_rgb(int color,int *r,int *g,int *b);
+int   vterm_color_dist(int r1,int g1,int b1,int r2,int g2,int b2);
+int   vterm_color_nearest(int r,int g,int b,int first,int last);
+short vterm_color_from_rgb(int r,int g,int b);
+
+// curses color pairs
 short find_color_pair(short fg,short bg);
 
 #endif // vterm_h
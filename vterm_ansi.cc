@@ -0,0 +1,472 @@
+////////////////////////////////////////////////////////////////////////////////
+// vterm_ansi.cc
+// // Based on libvterm by 2009 Bryan Christ
+// // and ROTE written by Bruno Takahashi C. de Oliveira.
+//
+// ansi output backend, writes escape sequences straight to a terminal
+
+#include "vterm.h"
+
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include <glib.h>
+
+/*
+   The backend keeps two cell buffers. Draws from vterm_update() land in the
+   back buffer, the front buffer is what the terminal is known to show. At
+   the end of an update the rows that were drawn are compared and only the
+   cells that differ are sent, with cursor motion between them and an SGR
+   sequence when the attributes change. Output that scrolled the whole
+   screen is sent as line feeds first and blank line endings are erased
+   with EL, as curses would. A frame is a single write().
+*/
+
+#define VTERM_ANSI_GAP  4        // unchanged cells rewritten rather than
+                                 // moving the cursor over them
+
+struct vterm_ansi_t {
+   int            fd;
+   int            rows;
+   int            cols;
+   vterm_cell_t   *front;                       // what the terminal shows
+   vterm_cell_t   *back;                        // what was last drawn
+   int            *dirty_start;                 // columns drawn per row
+   int            *dirty_end;
+   GString        *out;                         // the frame being built
+   int            crow;                         // terminal cursor, -1 if
+   int            ccol;                         // unknown
+   guint32        attr;                         // terminal attributes
+   gboolean       acs;                          // line drawing charset on
+   gboolean       clear;                        // clear screen next frame
+   gsize          bytes;                        // bytes written in total
+};
+
+static void vterm_ansi_draw(void *ctx,int row,int col,
+   const vterm_cell_t *cells,int count);
+static void vterm_ansi_bell(void *ctx);
+static void vterm_ansi_flush(void *ctx);
+
+const vterm_backend_t vterm_ansi_backend=
+{
+   vterm_ansi_draw,
+   vterm_ansi_bell,
+   vterm_ansi_flush
+};
+
+/* a cell as it looks on a freshly cleared screen */
+static const vterm_cell_t vterm_ansi_blank={' ',0};
+
+/* writes a whole buffer, retrying short writes */
+static void vterm_ansi_write(vterm_ansi_t *ansi,const char *buf,gsize len)
+{
+   ssize_t  bytes;
+
+   while(len > 0)
+   {
+      bytes=write(ansi->fd,buf,len);
+      if(bytes < 0)
+      {
+         if(errno == EINTR || errno == EAGAIN) continue;
+         return;
+      }
+      buf+=bytes;
+      len-=bytes;
+      ansi->bytes+=bytes;
+   }
+
+   return;
+}
+
+static void vterm_ansi_alloc(vterm_ansi_t *ansi,int rows,int cols)
+{
+   int   i;
+
+   g_free(ansi->front);
+   g_free(ansi->back);
+   g_free(ansi->dirty_start);
+   g_free(ansi->dirty_end);
+
+   ansi->rows=rows;
+   ansi->cols=cols;
+   ansi->front=g_new(vterm_cell_t,rows*cols);
+   ansi->back=g_new(vterm_cell_t,rows*cols);
+   ansi->dirty_start=g_new(int,rows);
+   ansi->dirty_end=g_new(int,rows);
+
+   for(i=0;i < rows*cols;i++)
+   {
+      ansi->front[i]=vterm_ansi_blank;
+      ansi->back[i]=vterm_ansi_blank;
+   }
+   for(i=0;i < rows;i++)
+   {
+      ansi->dirty_start[i]=cols;
+      ansi->dirty_end[i]=-1;
+   }
+
+   ansi->clear=TRUE;
+
+   return;
+}
+
+vterm_ansi_t* vterm_ansi_create(int fd,int rows,int cols)
+{
+   vterm_ansi_t   *ansi;
+
+   ansi=g_new0(vterm_ansi_t,1);
+   ansi->fd=fd;
+   ansi->out=g_string_sized_new(16384);
+   vterm_ansi_alloc(ansi,MAX(rows,1),MAX(cols,1));
+
+   /* vterm draws its own cursor cell, so hide the real one */
+   vterm_ansi_write(ansi,"\e[?25l",6);
+
+   return ansi;
+}
+
+void vterm_ansi_destroy(vterm_ansi_t *ansi)
+{
+   static const char reset[]="\e[0m\e(B\e[?25h";
+
+   if(ansi==NULL) return;
+
+   vterm_ansi_write(ansi,reset,sizeof(reset)-1);
+
+   g_string_free(ansi->out,TRUE);
+   g_free(ansi->front);
+   g_free(ansi->back);
+   g_free(ansi->dirty_start);
+   g_free(ansi->dirty_end);
+   g_free(ansi);
+
+   return;
+}
+
+/* the screen is cleared on the next frame, so vterm must redraw it all */
+void vterm_ansi_resize(vterm_ansi_t *ansi,int rows,int cols)
+{
+   if(ansi==NULL) return;
+
+   vterm_ansi_alloc(ansi,MAX(rows,1),MAX(cols,1));
+
+   return;
+}
+
+/* forget what the terminal shows (e.g. something else drew over it) */
+void vterm_ansi_invalidate(vterm_ansi_t *ansi)
+{
+   int   i;
+
+   if(ansi==NULL) return;
+
+   for(i=0;i < ansi->rows;i++)
+   {
+      ansi->dirty_start[i]=0;
+      ansi->dirty_end[i]=ansi->cols-1;
+   }
+   ansi->clear=TRUE;
+
+   return;
+}
+
+gsize vterm_ansi_get_bytes(vterm_ansi_t *ansi)
+{
+   if(ansi==NULL) return 0;
+
+   return ansi->bytes;
+}
+
+static void vterm_ansi_draw(void *ctx,int row,int col,
+   const vterm_cell_t *cells,int count)
+{
+   vterm_ansi_t   *ansi=(vterm_ansi_t*)ctx;
+
+   if(row < 0 || row >= ansi->rows || col < 0 || col >= ansi->cols) return;
+   if(count > ansi->cols-col) count=ansi->cols-col;
+   if(count <= 0) return;
+
+   memcpy(ansi->back+(row*ansi->cols)+col,cells,
+      sizeof(vterm_cell_t)*count);
+
+   if(col < ansi->dirty_start[row]) ansi->dirty_start[row]=col;
+   if(col+count-1 > ansi->dirty_end[row])
+      ansi->dirty_end[row]=col+count-1;
+
+   return;
+}
+
+static void vterm_ansi_bell(void *ctx)
+{
+   vterm_ansi_t   *ansi=(vterm_ansi_t*)ctx;
+
+   g_string_append_c(ansi->out,'\a');
+
+   return;
+}
+
+/* appends an SGR color parameter for a palette index (-1 is default) */
+static void vterm_ansi_color(GString *out,int color,int base,int bright)
+{
+   if(color < 0) g_string_append_printf(out,"%d",base+9);
+   else if(color < 8) g_string_append_printf(out,"%d",base+color);
+   else if(color < 16) g_string_append_printf(out,"%d",bright+color-8);
+   else g_string_append_printf(out,"%d;5;%d",base+8,color);
+
+   return;
+}
+
+/* switches the terminal to the attributes of a cell */
+static void vterm_ansi_attr(vterm_ansi_t *ansi,guint32 attr)
+{
+   GString  *out=ansi->out;
+   gboolean acs=(attr & VTERM_ATTR_ACS) ? TRUE : FALSE;
+
+   if(acs != ansi->acs)
+   {
+      g_string_append(out,acs ? "\e(0" : "\e(B");
+      ansi->acs=acs;
+   }
+
+   attr &= VTERM_ATTR_STYLE & ~VTERM_ATTR_ACS;
+   if(attr == ansi->attr) return;
+
+   g_string_append(out,"\e[");
+   if((attr & VTERM_ATTR_FLAGS) == (ansi->attr & VTERM_ATTR_FLAGS))
+   {
+      /* only the colors changed */
+      if(VTERM_ATTR_FG(attr) != VTERM_ATTR_FG(ansi->attr))
+      {
+         vterm_ansi_color(out,VTERM_ATTR_FG(attr),30,90);
+         if(VTERM_ATTR_BG(attr) != VTERM_ATTR_BG(ansi->attr))
+            g_string_append_c(out,';');
+      }
+      if(VTERM_ATTR_BG(attr) != VTERM_ATTR_BG(ansi->attr))
+         vterm_ansi_color(out,VTERM_ATTR_BG(attr),40,100);
+   }
+   else
+   {
+      /* from a reset, which is shorter than undoing single flags */
+      g_string_append_c(out,'0');
+      if(attr & VTERM_ATTR_BOLD) g_string_append(out,";1");
+      if(attr & VTERM_ATTR_BLINK) g_string_append(out,";5");
+      if(attr & VTERM_ATTR_REVERSE) g_string_append(out,";7");
+      if(attr & VTERM_ATTR_INVIS) g_string_append(out,";8");
+      if(VTERM_ATTR_FG(attr) >= 0)
+      {
+         g_string_append_c(out,';');
+         vterm_ansi_color(out,VTERM_ATTR_FG(attr),30,90);
+      }
+      if(VTERM_ATTR_BG(attr) >= 0)
+      {
+         g_string_append_c(out,';');
+         vterm_ansi_color(out,VTERM_ATTR_BG(attr),40,100);
+      }
+   }
+   g_string_append_c(out,'m');
+
+   ansi->attr=attr;
+
+   return;
+}
+
+/* moves the terminal cursor with the shortest sequence that works */
+static void vterm_ansi_move(vterm_ansi_t *ansi,int row,int col)
+{
+   if(row == ansi->crow && col == ansi->ccol) return;
+
+   if(row == ansi->crow && col > ansi->ccol)
+      g_string_append_printf(ansi->out,"\e[%dC",col-ansi->ccol);
+   else
+      g_string_append_printf(ansi->out,"\e[%d;%dH",row+1,col+1);
+
+   ansi->crow=row;
+   ansi->ccol=col;
+
+   return;
+}
+
+/* writes one cell at the cursor as utf-8, a wide char covers two columns.
+ * the right half of a wide char is only written as a blank when the left
+ * half is gone */
+static void vterm_ansi_put(vterm_ansi_t *ansi,const vterm_cell_t *cell)
+{
+   guint32  ch=cell->ch;
+
+   vterm_ansi_attr(ansi,cell->attr);
+
+   if(ch < 0x20 || ch == 0x7f || (cell->attr & VTERM_ATTR_WIDE_CONT)) ch=' ';
+
+   if(ch < 0x80) g_string_append_c(ansi->out,(gchar)ch);
+   else g_string_append_unichar(ansi->out,(gunichar)ch);
+
+   ansi->ccol+=(cell->attr & VTERM_ATTR_WIDE) ? 2 : 1;
+
+   /* the cursor doesn't move past the last column, it waits to wrap */
+   if(ansi->ccol >= ansi->cols) ansi->crow=-1;
+
+   return;
+}
+
+/* true if none of the cells are part of a wide char */
+static gboolean vterm_ansi_narrow(const vterm_cell_t *cells,int count)
+{
+   int   i;
+
+   for(i=0;i < count;i++)
+      if(cells[i].attr & (VTERM_ATTR_WIDE | VTERM_ATTR_WIDE_CONT))
+         return FALSE;
+
+   return TRUE;
+}
+
+static gboolean vterm_ansi_row_eq(vterm_ansi_t *ansi,int back_row,
+   int front_row)
+{
+   return memcmp(ansi->back+(back_row*ansi->cols),
+      ansi->front+(front_row*ansi->cols),
+      sizeof(vterm_cell_t)*ansi->cols) == 0;
+}
+
+/* finds how far the screen scrolled up since the last frame, by looking
+ * for the new top row further down the old screen. the scroll has to
+ * line up more rows than leaving the screen where it is */
+static int vterm_ansi_scrolled(vterm_ansi_t *ansi)
+{
+   int   n,y;
+   int   still=0;
+   int   match;
+
+   for(y=0;y < ansi->rows;y++)
+      if(vterm_ansi_row_eq(ansi,y,y)) still++;
+
+   for(n=1;n < ansi->rows-still;n++)
+   {
+      if(!vterm_ansi_row_eq(ansi,0,n)) continue;
+
+      match=0;
+      for(y=0;y+n < ansi->rows;y++)
+         if(vterm_ansi_row_eq(ansi,y,y+n)) match++;
+
+      if(match > still && match*2 > ansi->rows-n) return n;
+   }
+
+   return 0;
+}
+
+/* scrolls the terminal with line feeds at the bottom, then every row has
+ * to be compared again */
+static void vterm_ansi_scroll(vterm_ansi_t *ansi,int n)
+{
+   int   i;
+
+   vterm_ansi_attr(ansi,0);
+   vterm_ansi_move(ansi,ansi->rows-1,0);
+   for(i=0;i < n;i++) g_string_append_c(ansi->out,'\n');
+
+   memmove(ansi->front,ansi->front+(n*ansi->cols),
+      sizeof(vterm_cell_t)*(ansi->rows-n)*ansi->cols);
+   for(i=(ansi->rows-n)*ansi->cols;i < ansi->rows*ansi->cols;i++)
+      ansi->front[i]=vterm_ansi_blank;
+
+   for(i=0;i < ansi->rows;i++)
+   {
+      ansi->dirty_start[i]=0;
+      ansi->dirty_end[i]=ansi->cols-1;
+   }
+
+   return;
+}
+
+/* last column that isn't a default blank, -1 if the row is empty */
+static int vterm_ansi_row_end(const vterm_cell_t *row,int cols)
+{
+   while(cols > 0 && row[cols-1].ch == ' ' && row[cols-1].attr == 0) cols--;
+
+   return cols-1;
+}
+
+static void vterm_ansi_flush(void *ctx)
+{
+   vterm_ansi_t   *ansi=(vterm_ansi_t*)ctx;
+   vterm_cell_t   *front;
+   vterm_cell_t   *back;
+   int            x,y;
+   int            end;
+   int            dirty=0;
+
+   if(ansi->clear)
+   {
+      g_string_append(ansi->out,"\e[0m\e(B\e[H\e[2J");
+      for(x=0;x < ansi->rows*ansi->cols;x++) ansi->front[x]=vterm_ansi_blank;
+      ansi->attr=0;
+      ansi->acs=FALSE;
+      ansi->crow=0;
+      ansi->ccol=0;
+      ansi->clear=FALSE;
+   }
+
+   /* only worth looking for a scroll when most of the screen was drawn */
+   for(y=0;y < ansi->rows;y++)
+      if(ansi->dirty_end[y] >= 0) dirty++;
+   if(dirty*2 > ansi->rows)
+   {
+      x=vterm_ansi_scrolled(ansi);
+      if(x > 0) vterm_ansi_scroll(ansi,x);
+   }
+
+   for(y=0;y < ansi->rows;y++)
+   {
+      front=ansi->front+(y*ansi->cols);
+      back=ansi->back+(y*ansi->cols);
+      end=vterm_ansi_row_end(back,ansi->cols);
+
+      for(x=ansi->dirty_start[y];x <= ansi->dirty_end[y];x++)
+      {
+         if(back[x].ch == front[x].ch && back[x].attr == front[x].attr)
+            continue;
+
+         /* the right half of a wide char is sent by writing the char */
+         if(x > 0 && (back[x].attr & VTERM_ATTR_WIDE_CONT) &&
+            (back[x-1].attr & VTERM_ATTR_WIDE)) x--;
+
+         /* a short run of unchanged cells is cheaper to write again */
+         if(y == ansi->crow && x > ansi->ccol &&
+            x-ansi->ccol <= VTERM_ANSI_GAP &&
+            vterm_ansi_narrow(back+ansi->ccol,x-ansi->ccol))
+         {
+            while(ansi->ccol < x) vterm_ansi_put(ansi,&back[ansi->ccol]);
+         }
+
+         /* the rest of the row is blank, erase it in one go */
+         if(x > end)
+         {
+            vterm_ansi_move(ansi,y,x);
+            vterm_ansi_attr(ansi,0);
+            g_string_append(ansi->out,"\e[K");
+            for(;x < ansi->cols;x++) front[x]=vterm_ansi_blank;
+            break;
+         }
+
+         vterm_ansi_move(ansi,y,x);
+         vterm_ansi_put(ansi,&back[x]);
+         front[x]=back[x];
+         if((back[x].attr & VTERM_ATTR_WIDE) && x+1 < ansi->cols)
+         {
+            x++;
+            front[x]=back[x];
+         }
+      }
+
+      ansi->dirty_start[y]=ansi->cols;
+      ansi->dirty_end[y]=-1;
+   }
+
+   if(ansi->out->len == 0) return;
+
+   vterm_ansi_write(ansi,ansi->out->str,ansi->out->len);
+   g_string_truncate(ansi->out,0);
+
+   return;
+}
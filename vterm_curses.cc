@@ -0,0 +1,219 @@
+////////////////////////////////////////////////////////////////////////////////
+// vterm_curses.cc
+// // Based on libvterm by 2009 Bryan Christ
+// // and ROTE written by Bruno Takahashi C. de Oliveira.
+//
+// ncurses output backend, paints vterm cells into a curses WINDOW
+
+#include "vterm.h"
+
+#include <limits.h>
+
+#include <glib.h>
+#include <curses.h>
+
+static void vterm_curses_draw(void *ctx,int row,int col,
+   const vterm_cell_t *cells,int count);
+static void vterm_curses_bell(void *ctx);
+
+const vterm_backend_t vterm_curses_backend=
+{
+   vterm_curses_draw,
+   vterm_curses_bell,
+   NULL
+};
+
+void vterm_wnd_set(vterm_t *vterm,WINDOW *window)
+{
+   if(vterm==NULL) return;
+
+   if(window==NULL) vterm_set_backend(vterm,NULL,NULL);
+   else vterm_set_backend(vterm,&vterm_curses_backend,window);
+
+   return;
+}
+
+WINDOW* vterm_wnd_get(vterm_t *vterm)
+{
+   return (WINDOW*)vterm_get_backend_ctx(vterm,&vterm_curses_backend);
+}
+
+/* converts vterm cell attributes to curses attributes and color pair */
+static attr_t vterm_curses_attr(guint32 attr)
+{
+   attr_t   cattr=A_NORMAL;
+   short    colors;
+
+   if(attr & VTERM_ATTR_BOLD) cattr |= A_BOLD;
+   if(attr & VTERM_ATTR_BLINK) cattr |= A_BLINK;
+   if(attr & VTERM_ATTR_REVERSE) cattr |= A_REVERSE;
+   if(attr & VTERM_ATTR_INVIS) cattr |= A_INVIS;
+
+   colors=find_color_pair(VTERM_ATTR_FG(attr),VTERM_ATTR_BG(attr));
+   if(colors==-1) colors=0;
+
+   return cattr | COLOR_PAIR(colors);
+}
+
+static void vterm_curses_draw(void *ctx,int row,int col,
+   const vterm_cell_t *cells,int count)
+{
+   WINDOW   *window=(WINDOW*)ctx;
+   guint32  attr;
+   guint32  ch;
+   wchar_t  wch[2]={0,0};
+   cchar_t  cch;
+   int      i;
+
+   wmove(window,row,col);
+
+   /* neighbouring cells mostly share attributes, so only convert and set
+      them when they change */
+   attr=cells[0].attr;
+   wattrset(window,vterm_curses_attr(attr));
+
+   for(i=0;i < count;i++)
+   {
+      if(cells[i].attr != attr)
+      {
+         attr=cells[i].attr;
+         wattrset(window,vterm_curses_attr(attr));
+      }
+
+      ch=cells[i].ch;
+
+      /* the right half of a wide char was drawn with its left half, one
+         without a left half is shown blank */
+      if(attr & VTERM_ATTR_WIDE_CONT)
+      {
+         if(i > 0 && (cells[i-1].attr & VTERM_ATTR_WIDE)) continue;
+         ch=' ';
+      }
+
+      if(attr & VTERM_ATTR_ACS) waddch(window,NCURSES_ACS(ch));
+      else if(ch < 0x80) waddch(window,ch);
+      else
+      {
+         /* the window attributes set above are merged in by curses */
+         wch[0]=(wchar_t)ch;
+         setcchar(&cch,wch,A_NORMAL,0,NULL);
+         wadd_wch(window,&cch);
+      }
+   }
+
+   return;
+}
+
+static void vterm_curses_bell(void *)
+{
+   beep();
+
+   return;
+}
+
+/*
+   Color pair cache
+
+   Pairs are allocated lazily with init_pair the first time a (fg,bg)
+   combination is used and remembered in a dense table, so looking up the
+   pair for an SGR change is a single index. Colors are -1 (default) or a
+   palette index. Colors the terminal can't show are quantized down to the
+   8/16 ansi colors, and once the pairs run out a combination is mapped to
+   the closest pair that was already allocated.
+*/
+
+static short   *color_pair_map=NULL;            // (fg,bg) -> pair, 0 if unset
+static gint     color_pair_dim=0;               // palette size + 1 (default)
+static gint     color_pair_next=1;              // next free pair
+static gint     color_pair_max=0;               // pairs usable in a chtype
+
+/* maps a palette index onto the colors the terminal supports */
+static short vterm_color_fit(short color)
+{
+   int   r,g,b;
+
+   if(color < 0 || color < color_pair_dim-1) return color;
+
+   vterm_color_rgb(color,&r,&g,&b);
+
+   return vterm_color_nearest(r,g,b,0,(color_pair_dim-1 >= 16) ? 16 : 8);
+}
+
+/* finds the allocated pair that looks most like fg/bg */
+static short vterm_color_nearest_pair(short fg,short bg)
+{
+   short pfg,pbg;
+   int   i;
+   int   fr,fg_,fb,br,bg_,bb;
+   int   r,g,b;
+   int   dist;
+   int   best=0;
+   int   best_dist=INT_MAX;
+
+   if(fg >= 0) vterm_color_rgb(fg,&fr,&fg_,&fb);
+   if(bg >= 0) vterm_color_rgb(bg,&br,&bg_,&bb);
+
+   for(i=1;i < color_pair_next;i++)
+   {
+      pair_content(i,&pfg,&pbg);
+
+      /* default colors only match default colors */
+      if((fg < 0) != (pfg < 0) || (bg < 0) != (pbg < 0)) continue;
+
+      dist=0;
+      if(fg >= 0)
+      {
+         vterm_color_rgb(pfg,&r,&g,&b);
+         dist+=vterm_color_dist(fr,fg_,fb,r,g,b);
+      }
+      if(bg >= 0)
+      {
+         vterm_color_rgb(pbg,&r,&g,&b);
+         dist+=vterm_color_dist(br,bg_,bb,r,g,b);
+      }
+
+      if(dist < best_dist)
+      {
+         best=i;
+         best_dist=dist;
+      }
+   }
+
+   return best;
+}
+
+short find_color_pair(short fg,short bg)
+{
+   short *slot;
+
+   if(has_colors()==FALSE) return -1;
+
+   if(color_pair_map==NULL)
+   {
+      color_pair_dim=MIN(COLORS,256)+1;
+      color_pair_max=MIN(COLOR_PAIRS,VTERM_MAX_PAIRS);
+      color_pair_map=(short*)g_malloc0(sizeof(short)*
+         color_pair_dim*color_pair_dim);
+   }
+
+   fg=vterm_color_fit(CLAMP(fg,-1,255));
+   bg=vterm_color_fit(CLAMP(bg,-1,255));
+
+   /* pair 0 is always the terminal's default colors */
+   if(fg < 0 && bg < 0) return 0;
+
+   slot=&color_pair_map[((fg+1)*color_pair_dim)+(bg+1)];
+   if(*slot) return *slot;
+
+   if(color_pair_next < color_pair_max &&
+      init_pair(color_pair_next,fg,bg) != ERR)
+   {
+      *slot=color_pair_next++;
+   }
+   else
+   {
+      *slot=vterm_color_nearest_pair(fg,bg);
+   }
+
+   return *slot;
+}